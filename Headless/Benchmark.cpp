@@ -0,0 +1,383 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "Benchmark.h"
+#include "Game.h"
+#include "JobSystem.h"
+#include "LevelFile.h"
+#include "Player.h"
+#include "ProjectileCollisions.h"
+#include "Random.h"
+#include "ShaderProgram.h"
+#include "TileMap.h"
+
+
+#define TEMPLATE_LEVEL_FILE "levels/level01.lvl"
+#define BENCHMARK_LEVEL_FILE "levels/benchmark.lvl"
+#define ENEMY_SPRITE_FILE "images/enemy_character.txt"
+
+#define DEFAULT_TOLERANCE 10.f     // Percent
+#define DEFAULT_SAMPLE_MS 20.0
+#define SAMPLES 7
+#define MAX_SIZES 4
+
+// Queries cycle through this many precomputed inputs
+#define QUERY_POSITIONS 1024
+#define VIEW_WIDTH 256
+#define VIEW_HEIGHT 240
+#define COLLISION_BULLETS 1024
+
+
+enum CollisionDirection { COLLISION_DOWN, COLLISION_LEFT, COLLISION_RIGHT };
+
+
+// Results of every benchmark go through here so the compiler cannot drop the work
+static volatile int sink;
+
+
+// Level of the given width in tiles, made of the columns of level01 repeated
+static bool generateLevel(int width)
+{
+	LevelFile source, level;
+
+	if(!source.load(TEMPLATE_LEVEL_FILE))
+		return false;
+	level.createTiled(source, width);
+
+	return level.saveBinary(BENCHMARK_LEVEL_FILE);
+}
+
+static vector<glm::ivec2> randomPositions(int width, int height)
+{
+	vector<glm::ivec2> positions;
+	Random random(DEFAULT_SEED);
+
+	for(int i=0; i<QUERY_POSITIONS; i++)
+		positions.push_back(glm::ivec2(random.range(0, width - 1), random.range(0, height - 1)));
+
+	return positions;
+}
+
+// Enemies standing at random along a view, all of them active
+static void createEnemies(EntityStore &entities, int count, vector<int> &active)
+{
+	Random random(DEFAULT_SEED);
+	int type = entities.addType(ENEMY_SPRITE_FILE);
+
+	for(int i=0; i<count; i++)
+	{
+		int id = entities.create(type, glm::ivec2(random.range(0, VIEW_WIDTH), random.range(0, VIEW_HEIGHT - 48)), TEAM_ENEMY, random.range(MOVE_LEFT, MOVE_RIGHT));
+		if(id != -1)
+			active.push_back(id);
+	}
+}
+
+// TileMap::loadLevel and prepareArrays, through the constructor. A second
+// map keeps the tilesheet in the TextureManager so only the level is loaded.
+static void benchTileMapCreate(int width, BenchmarkState &state)
+{
+	ShaderProgram program;
+
+	if(!generateLevel(width))
+		return;
+	TileMap *resident = TileMap::createTileMap(BENCHMARK_LEVEL_FILE, glm::vec2(0.f), program);
+	while(state.keepRunning())
+	{
+		TileMap *map = TileMap::createTileMap(BENCHMARK_LEVEL_FILE, glm::vec2(0.f), program);
+		sink = map->getSize().x;
+		map->free();
+		delete map;
+	}
+	resident->free();
+	delete resident;
+}
+
+// One section enters the view on every operation and is meshed
+static void benchTileMapStream(int width, BenchmarkState &state)
+{
+	ShaderProgram program;
+	float left = 0.f;
+
+	if(!generateLevel(width))
+		return;
+	TileMap *map = TileMap::createTileMap(BENCHMARK_LEVEL_FILE, glm::vec2(0.f), program);
+	float step = float(SECTION_COLUMNS * map->getTileSize());
+	float end = float(map->getSize().x * map->getTileSize()) - VIEW_WIDTH;
+	while(state.keepRunning())
+	{
+		sink = map->streamSections(left, left + VIEW_WIDTH);
+		left = (left + step < end) ? left + step : 0.f;
+	}
+	map->free();
+	delete map;
+}
+
+// Tile collisions of a player sized box at random places of the level
+template<CollisionDirection direction>
+static void benchCollision(int width, BenchmarkState &state)
+{
+	ShaderProgram program;
+	int i = 0, life = 3;
+
+	if(!generateLevel(width))
+		return;
+	TileMap *map = TileMap::createTileMap(BENCHMARK_LEVEL_FILE, glm::vec2(0.f), program);
+	vector<glm::ivec2> positions = randomPositions(map->getSize().x * map->getTileSize() - 48, map->getSize().y * map->getTileSize() - 48);
+	while(state.keepRunning())
+	{
+		int posY = positions[i].y;
+
+		if(direction == COLLISION_DOWN)
+			sink = map->collisionMoveDown(positions[i], glm::ivec2(16, 34), &posY, &life);
+		else if(direction == COLLISION_LEFT)
+			sink = map->collisionMoveLeft(positions[i], glm::ivec2(16, 34));
+		else
+			sink = map->collisionMoveRight(positions[i], glm::ivec2(16, 34));
+		i = (i + 1) % QUERY_POSITIONS;
+	}
+	map->free();
+	delete map;
+}
+
+// The animation pass that replaced Sprite::update, over walking enemies
+static void benchUpdateAnimations(int count, BenchmarkState &state)
+{
+	EntityStore *entities = new EntityStore();
+	vector<int> active;
+
+	entities->init(glm::ivec2(0));
+	createEnemies(*entities, count, active);
+	while(state.keepRunning())
+		entities->updateAnimations(TICK_TIME);
+	sink = entities->getCount();
+	delete entities;
+}
+
+// The bullet pass that replaced Bullet::update. Expired bullets are
+// spawned again, so count bullets stay in flight.
+static void benchProjectilesUpdate(int count, BenchmarkState &state)
+{
+	ProjectileSystem *projectiles = new ProjectileSystem();
+	Random random(DEFAULT_SEED);
+
+	projectiles->init();
+	projectiles->fill(count, glm::ivec2(0), glm::ivec2(VIEW_WIDTH, VIEW_HEIGHT), random);
+	while(state.keepRunning())
+	{
+		projectiles->update(TICK_TIME);
+		projectiles->fill(count, glm::ivec2(0), glm::ivec2(VIEW_WIDTH, VIEW_HEIGHT), random);
+	}
+	sink = projectiles->getLiveCount();
+	delete projectiles;
+}
+
+// The bullet against enemy test of Scene::update, with COLLISION_BULLETS
+// bullets, half of each team, among count enemies in view
+static void benchProjectileCollisions(int count, BenchmarkState &state)
+{
+	EntityStore *entities = new EntityStore();
+	ProjectileSystem *projectiles = new ProjectileSystem();
+	ProjectileCollisions collisions;
+	vector<int> active;
+	Random random(DEFAULT_SEED);
+
+	entities->init(glm::ivec2(0));
+	createEnemies(*entities, count, active);
+	projectiles->init();
+	projectiles->fill(COLLISION_BULLETS, glm::ivec2(0), glm::ivec2(VIEW_WIDTH, VIEW_HEIGHT), random);
+	collisions.init(float(VIEW_WIDTH));
+	while(state.keepRunning())
+	{
+		collisions.find(*entities, active, *projectiles, glm::vec2(100.f, 100.f), glm::vec2(120.f, 140.f), 0.f);
+		sink = collisions.getNumEnemyHits();
+	}
+	delete projectiles;
+	delete entities;
+}
+
+static void benchPlayerGetHitbox(int size, BenchmarkState &state)
+{
+	EntityStore *entities = new EntityStore();
+	Player player;
+
+	entities->init(glm::ivec2(0));
+	player.init(*entities, glm::ivec2(0));
+	while(state.keepRunning())
+		sink = player.getHitbox(true).x + player.getHitbox(false).y;
+	delete entities;
+}
+
+
+struct BenchmarkCase
+{
+	const char *name;
+	void (*function)(int size, BenchmarkState &state);
+	int nSizes;
+	int sizes[MAX_SIZES];
+};
+
+// Sizes are level widths in tiles, entities or bullets
+static const BenchmarkCase benchmarks[] =
+{
+	{ "tilemap_create", benchTileMapCreate, 3, { 100, 400, 1600 } },
+	{ "tilemap_stream", benchTileMapStream, 3, { 100, 400, 1600 } },
+	{ "tilemap_collision_down", benchCollision<COLLISION_DOWN>, 3, { 100, 400, 1600 } },
+	{ "tilemap_collision_left", benchCollision<COLLISION_LEFT>, 3, { 100, 400, 1600 } },
+	{ "tilemap_collision_right", benchCollision<COLLISION_RIGHT>, 3, { 100, 400, 1600 } },
+	{ "entities_update_animations", benchUpdateAnimations, 3, { 64, 512, MAX_ENTITIES } },
+	{ "projectiles_update", benchProjectilesUpdate, 3, { 64, 512, MAX_PROJECTILES } },
+	{ "projectile_collisions", benchProjectileCollisions, 3, { 16, 128, 1024 } },
+	{ "player_get_hitbox", benchPlayerGetHitbox, 1, { 1 } }
+};
+
+
+BenchmarkState::BenchmarkState(double sampleSeconds, int nSamples)
+{
+	this->sampleSeconds = sampleSeconds;
+	this->nSamples = nSamples;
+	iteration = 0;
+	batchSize = 0;
+	calibrating = true;
+}
+
+bool BenchmarkState::nextBatch()
+{
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	double elapsed = chrono::duration<double>(now - start).count();
+
+	if(batchSize == 0)
+		batchSize = 1;
+	else if(calibrating && elapsed < sampleSeconds)
+	{
+		// Aim a bit over the sample time, growing at most 10 times per batch
+		double factor = elapsed > 0.0 ? 1.2 * sampleSeconds / elapsed : 10.0;
+		batchSize = max(batchSize + 1, (long long)(batchSize * min(factor, 10.0)));
+	}
+	else
+	{
+		calibrating = false;
+		samples.push_back(elapsed * 1e9 / batchSize);
+		if(int(samples.size()) == nSamples)
+		{
+			sort(samples.begin(), samples.end());
+			return false;
+		}
+	}
+	iteration = 0;
+	start = chrono::steady_clock::now();
+
+	return true;
+}
+
+
+Benchmark::Benchmark()
+{
+	tolerance = DEFAULT_TOLERANCE;
+	sampleSeconds = DEFAULT_SAMPLE_MS / 1000.0;
+}
+
+
+bool Benchmark::setParameter(const string &name, const string &value)
+{
+	if(name == "-filter")
+		filter = value;
+	else if(name == "-baseline")
+		return loadBaseline(value);
+	else if(name == "-tolerance")
+	{
+		tolerance = float(atof(value.c_str()));
+		return tolerance > 0.f;
+	}
+	else if(name == "-min-time")
+	{
+		sampleSeconds = atof(value.c_str()) / 1000.0;
+		return sampleSeconds > 0.0;
+	}
+	else
+		return false;
+
+	return true;
+}
+
+int Benchmark::run(ostream &out)
+{
+	int nRegressions = 0;
+
+	out << "benchmark,size,workers,iterations,ns_per_op,min_ns_per_op,baseline_ns_per_op,change_percent" << endl;
+	for(unsigned int b=0; b<sizeof(benchmarks) / sizeof(benchmarks[0]); b++)
+	{
+		const BenchmarkCase &benchmark = benchmarks[b];
+
+		if(string(benchmark.name).find(filter) == string::npos)
+			continue;
+		for(int s=0; s<benchmark.nSizes; s++)
+		{
+			BenchmarkState state(sampleSeconds, SAMPLES);
+			stringstream key;
+
+			benchmark.function(benchmark.sizes[s], state);
+			if(state.getSamples().empty())
+			{
+				cerr << "Could not set up " << benchmark.name << " " << benchmark.sizes[s] << endl;
+				continue;
+			}
+			double median = state.getSamples()[SAMPLES / 2];
+			out << benchmark.name << "," << benchmark.sizes[s] << "," << JobSystem::instance().getWorkerCount() << ","
+				<< state.getBatchSize() << "," << median << "," << state.getSamples()[0] << ",";
+
+			key << benchmark.name << "," << benchmark.sizes[s];
+			map<string, double>::const_iterator previous = baseline.find(key.str());
+			if(previous == baseline.end())
+			{
+				out << "," << endl;
+				continue;
+			}
+			double change = 100.0 * (median - previous->second) / previous->second;
+			out << previous->second << "," << change << endl;
+			if(change > tolerance)
+			{
+				cerr << "Regression in " << key.str() << ": " << previous->second << " -> " << median << " ns per operation" << endl;
+				nRegressions++;
+			}
+		}
+	}
+	remove(BENCHMARK_LEVEL_FILE);
+
+	return nRegressions;
+}
+
+// Rows are looked up by benchmark and size, the rest of the columns of the
+// baseline are only informative
+bool Benchmark::loadBaseline(const string &filename)
+{
+	ifstream fin(filename.c_str());
+	string line;
+
+	if(!fin.is_open())
+	{
+		cerr << "Could not open baseline " << filename << endl;
+		return false;
+	}
+	baseline.clear();
+	getline(fin, line);
+	while(getline(fin, line))
+	{
+		stringstream sstream(line);
+		string name, size, column;
+		double nsPerOp;
+
+		if(!getline(sstream, name, ',') || !getline(sstream, size, ','))
+			continue;
+		// Skip workers and iterations
+		getline(sstream, column, ',');
+		getline(sstream, column, ',');
+		if(getline(sstream, column, ',') && stringstream(column) >> nsPerOp)
+			baseline[name + "," + size] = nsPerOp;
+	}
+
+	return true;
+}
+
@@ -0,0 +1,88 @@
+#ifndef _BENCHMARK_INCLUDE
+#define _BENCHMARK_INCLUDE
+
+
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+using namespace std;
+
+
+// BenchmarkState times the loop of one benchmark, which runs its
+// operation while keepRunning() returns true. The first batches find how
+// many operations take at least the sample time, then that many are
+// timed once per sample. The clock is only read between batches.
+
+class BenchmarkState
+{
+
+public:
+	BenchmarkState(double sampleSeconds, int nSamples);
+
+	bool keepRunning()
+	{
+		if(++iteration < batchSize)
+			return true;
+		return nextBatch();
+	}
+
+	long long getBatchSize() const { return batchSize; }
+	// Nanoseconds per operation of every sample, sorted
+	const vector<double> &getSamples() const { return samples; }
+
+private:
+	bool nextBatch();
+
+private:
+	double sampleSeconds;
+	int nSamples;
+	long long iteration, batchSize;
+	bool calibrating;
+	chrono::steady_clock::time_point start;
+	vector<double> samples;
+
+};
+
+
+// Benchmark runs isolated benchmarks of the engine's hot functions over
+// several input sizes: level loading and meshing, tile collisions,
+// animation, bullet movement, bullet collisions and the player hitbox.
+// Every benchmark sets up its own data (generated levels, entities and
+// bullets), so results do not depend on the state of the game.
+//
+// Results are written as CSV, one row per benchmark and size. A previous
+// output can be given as baseline; rows slower than it by more than the
+// tolerance are reported as regressions.
+
+
+class Benchmark
+{
+
+public:
+	Benchmark();
+
+	// name is -filter (substring of the benchmark names to run), -baseline
+	// (CSV file written by a previous run), -tolerance (percent) or -min-time
+	// (milliseconds per sample). Returns false for any other name or bad values.
+	bool setParameter(const string &name, const string &value);
+	// The game must be initialized. Returns the number of regressions.
+	int run(ostream &out);
+
+private:
+	bool loadBaseline(const string &filename);
+
+private:
+	string filter;
+	float tolerance;
+	double sampleSeconds;
+	map<string, double> baseline;    // ns per operation by "name,size"
+
+};
+
+
+#endif // _BENCHMARK_INCLUDE
+
@@ -0,0 +1,195 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "Game.h"
+#include "Profiler.h"
+#include "JobSystem.h"
+#include "SoundBackend.h"
+#include "StressTest.h"
+#include "Benchmark.h"
+#include "InputScript.h"
+
+
+using namespace std;
+
+
+// Runs the game simulation without a window, an OpenGL context or audio.
+// The game sources are built against the headers in shims/, which turn
+// rendering into no-ops, sound goes to the null backend and input comes
+// from a script.
+//
+// Usage: Headless [ticks] [script] [-seed n] [-record file] [-replay file] [-workers n] [-profile path]
+// It has to be run from the game directory, where images/, levels/ and
+// shaders/ are. The script format is described in InputScript; without a
+// script the player walks right, jumping and shooting.
+// -record and -replay use the same files as the game, so a run played by
+// hand can be replayed here, as many times as needed, with identical results.
+// A replay lasts as many ticks as the recorded run unless ticks is given.
+// -workers sets the number of JobSystem threads, 0 runs everything on one thread.
+// -profile writes the profile summary and Chrome trace of profiled builds
+// to <path>.txt and <path>.json, as the game does.
+//
+// Headless -stress [ticks] [-width list] [-density list] [-fire-rate list] [-projectiles list]
+// runs generated levels instead (see StressTest) and prints a CSV table.
+// Lists are comma separated; every combination is run for ticks ticks.
+//
+// Headless -bench [-filter name] [-baseline file] [-tolerance percent] [-min-time ms]
+// runs the microbenchmarks (see Benchmark) and prints a CSV table. Saving
+// it gives a baseline for later runs, which exit with 2 if any benchmark
+// got slower than the tolerance.
+
+
+#define DEFAULT_TICKS 36000 // 10 minutes of game time
+#define DEFAULT_STRESS_TICKS 3600
+
+
+static bool parseArguments(int argc, char **argv, int &nTicks, string &scriptFile, string &recordFile, string &replayFile, bool &stress, StressTest &stressTest, bool &bench, Benchmark &benchmark)
+{
+	int nPositional = 0;
+
+	for(int i=1; i<argc; i++)
+	{
+		string argument = argv[i];
+
+		if(argument == "-stress")
+			stress = true;
+		else if(argument == "-bench")
+			bench = true;
+		else if(argument[0] == '-')
+		{
+			if(i + 1 >= argc)
+				return false;
+			string value = argv[++i];
+			if(argument == "-seed")
+				Game::instance().setSeed((unsigned int)strtoul(value.c_str(), NULL, 10));
+			else if(argument == "-record")
+				recordFile = value;
+			else if(argument == "-replay")
+				replayFile = value;
+			else if(argument == "-workers")
+				JobSystem::instance().setWorkerCount(atoi(value.c_str()));
+			else if(argument == "-profile")
+				Game::instance().setProfileOutput(value);
+			else if(!stressTest.setParameter(argument, value) && !benchmark.setParameter(argument, value))
+				return false;
+		}
+		else if(nPositional == 0)
+		{
+			nTicks = atoi(argv[i]);
+			if(nTicks <= 0)
+				return false;
+			nPositional++;
+		}
+		else if(nPositional == 1)
+		{
+			scriptFile = argument;
+			nPositional++;
+		}
+		else
+			return false;
+	}
+
+	return true;
+}
+
+static int runStressTest(int nTicks, StressTest &stressTest)
+{
+	Game::instance().setSoundBackend(new NullSoundBackend());
+	Game::instance().init();
+	stressTest.run(nTicks > 0 ? nTicks : DEFAULT_STRESS_TICKS, cout);
+
+	return 0;
+}
+
+static int runBenchmarks(Benchmark &benchmark)
+{
+	Game::instance().setSoundBackend(new NullSoundBackend());
+	Game::instance().init();
+
+	return benchmark.run(cout) > 0 ? 2 : 0;
+}
+
+
+int main(int argc, char **argv)
+{
+	int nTicks = 0, tick;
+	string scriptFile, recordFile, replayFile;
+	InputScript script;
+	chrono::steady_clock::time_point start, end;
+	double initSeconds, runSeconds;
+	bool stress = false, bench = false;
+	StressTest stressTest;
+	Benchmark benchmark;
+
+	if(!parseArguments(argc, argv, nTicks, scriptFile, recordFile, replayFile, stress, stressTest, bench, benchmark))
+	{
+		cout << "Usage: " << argv[0] << " [ticks] [script] [-seed n] [-record file] [-replay file] [-workers n] [-profile path]" << endl;
+		cout << "       " << argv[0] << " -stress [ticks] [-width list] [-density list] [-fire-rate list] [-projectiles list] [-seed n] [-workers n]" << endl;
+		cout << "       " << argv[0] << " -bench [-filter name] [-baseline file] [-tolerance percent] [-min-time ms] [-workers n]" << endl;
+		return 1;
+	}
+	if(stress)
+		return runStressTest(nTicks, stressTest);
+	if(bench)
+		return runBenchmarks(benchmark);
+	if(!replayFile.empty())
+	{
+		if(!Game::instance().startReplay(replayFile))
+		{
+			cout << "Could not open recording " << replayFile << endl;
+			return 1;
+		}
+		if(nTicks == 0)
+			nTicks = Game::instance().getReplayLength();
+	}
+	if(nTicks == 0)
+		nTicks = DEFAULT_TICKS;
+	if(!scriptFile.empty())
+	{
+		if(!script.load(scriptFile))
+		{
+			cout << "Could not load script " << scriptFile << endl;
+			return 1;
+		}
+	}
+	else if(replayFile.empty())
+		script.buildDefault(nTicks);
+	if(!recordFile.empty() && !Game::instance().startRecording(recordFile))
+	{
+		cout << "Could not create recording " << recordFile << endl;
+		return 1;
+	}
+
+	start = chrono::steady_clock::now();
+	Game::instance().setSoundBackend(new NullSoundBackend());
+	Game::instance().init();
+	end = chrono::steady_clock::now();
+	initSeconds = chrono::duration<double>(end - start).count();
+
+	start = chrono::steady_clock::now();
+	// Script ticks are game ticks, which do not advance while a level loads
+	while(Game::instance().getTick() < nTicks)
+	{
+		script.queueUntil(Game::instance().getTick());
+		if(!Game::instance().update(TICK_TIME))
+			break;
+		PROFILE_FRAME();
+	}
+	tick = Game::instance().getTick();
+	end = chrono::steady_clock::now();
+	runSeconds = chrono::duration<double>(end - start).count();
+
+	cout << "Workers: " << JobSystem::instance().getWorkerCount() << endl;
+	cout << "Init: " << initSeconds * 1000.0 << " ms" << endl;
+	cout << "Simulated " << tick << " ticks (" << tick / float(TICKS_PER_SECOND) << " s of game time) in " << runSeconds * 1000.0 << " ms" << endl;
+	cout << "Ticks per second: " << (runSeconds > 0.0 ? tick / runSeconds : 0.0) << endl;
+	cout << "Microseconds per tick: " << (tick > 0 ? runSeconds * 1e6 / tick : 0.0) << endl;
+#ifdef ENABLE_PROFILER
+	// Every tick is a frame here
+	Profiler::instance().printSummary(cout);
+#endif
+
+	return 0;
+}
+
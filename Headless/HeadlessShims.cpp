@@ -0,0 +1,136 @@
+#include <cstring>
+#include <fstream>
+#include <GL/glew.h>
+#include <SOIL.h>
+
+
+using namespace std;
+
+
+// Every generated object gets a new name, they are never reused
+static GLuint nextName = 1;
+
+static void generateNames(GLsizei n, GLuint *names)
+{
+	for(GLsizei i=0; i<n; i++)
+		names[i] = nextName++;
+}
+
+
+GLboolean glewExperimental = GL_FALSE;
+
+GLenum glewInit()
+{
+	return 0;
+}
+
+void glClear(GLbitfield mask) {}
+void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {}
+void glPixelStorei(GLenum pname, GLint param) {}
+
+void glGenTextures(GLsizei n, GLuint *textures) { generateNames(n, textures); }
+void glDeleteTextures(GLsizei n, const GLuint *textures) {}
+void glActiveTexture(GLenum texture) {}
+void glBindTexture(GLenum target, GLuint texture) {}
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void *pixels) {}
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels) {}
+void glTexParameteriv(GLenum target, GLenum pname, const GLint *params) {}
+void glGenerateMipmap(GLenum target) {}
+void glGenSamplers(GLsizei n, GLuint *samplers) { generateNames(n, samplers); }
+void glBindSampler(GLuint unit, GLuint sampler) {}
+void glSamplerParameteri(GLuint sampler, GLenum pname, GLint param) {}
+
+void glGenBuffers(GLsizei n, GLuint *buffers) { generateNames(n, buffers); }
+void glDeleteBuffers(GLsizei n, const GLuint *buffers) {}
+void glBindBuffer(GLenum target, GLuint buffer) {}
+void glBufferData(GLenum target, GLsizeiptr size, const void *data, GLenum usage) {}
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void *data) {}
+void glGenVertexArrays(GLsizei n, GLuint *arrays) { generateNames(n, arrays); }
+void glDeleteVertexArrays(GLsizei n, const GLuint *arrays) {}
+void glBindVertexArray(GLuint array) {}
+void glEnableVertexAttribArray(GLuint index) {}
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer) {}
+void glDrawArrays(GLenum mode, GLint first, GLsizei count) {}
+void glMultiDrawArrays(GLenum mode, const GLint *first, const GLsizei *count, GLsizei drawcount) {}
+
+// Queries are available at once and measure nothing
+void glGenQueries(GLsizei n, GLuint *ids) { generateNames(n, ids); }
+void glDeleteQueries(GLsizei n, const GLuint *ids) {}
+void glBeginQuery(GLenum target, GLuint id) {}
+void glEndQuery(GLenum target) {}
+void glGetQueryObjectiv(GLuint id, GLenum pname, GLint *params) { *params = (pname == GL_QUERY_RESULT_AVAILABLE) ? GL_TRUE : 0; }
+void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64 *params) { *params = 0; }
+
+GLuint glCreateShader(GLenum type) { return nextName++; }
+void glDeleteShader(GLuint shader) {}
+void glShaderSource(GLuint shader, GLsizei count, const GLchar *const *string, const GLint *length) {}
+void glCompileShader(GLuint shader) {}
+GLuint glCreateProgram() { return nextName++; }
+void glDeleteProgram(GLuint program) {}
+void glAttachShader(GLuint program, GLuint shader) {}
+void glBindAttribLocation(GLuint program, GLuint index, const GLchar *name) {}
+void glLinkProgram(GLuint program) {}
+void glUseProgram(GLuint program) {}
+GLint glGetAttribLocation(GLuint program, const GLchar *name) { return 0; }
+GLint glGetUniformLocation(GLuint program, const GLchar *name) { return -1; }
+void glUniform2f(GLint location, GLfloat v0, GLfloat v1) {}
+void glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) {}
+void glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) {}
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat *value) {}
+
+// Compilation and linking always succeed and programs have no active uniforms
+
+void glGetShaderiv(GLuint shader, GLenum pname, GLint *params)
+{
+	*params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint *params)
+{
+	*params = (pname == GL_LINK_STATUS) ? GL_TRUE : 0;
+}
+
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+	if(length != NULL)
+		*length = 0;
+	if(bufSize > 0)
+		infoLog[0] = '\0';
+}
+
+void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei *length, GLchar *infoLog)
+{
+	glGetShaderInfoLog(program, bufSize, length, infoLog);
+}
+
+void glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei *length, GLint *size, GLenum *type, GLchar *name)
+{
+	glGetShaderInfoLog(program, bufSize, length, name);
+	*size = 0;
+	*type = 0;
+}
+
+
+unsigned char *SOIL_load_image(const char *filename, int *width, int *height, int *channels, int forceChannels)
+{
+	ifstream fin(filename, ios::binary);
+	unsigned char header[24];
+
+	// PNG signature followed by the IHDR chunk, which starts with the big endian size
+	if(!fin.read((char *)header, sizeof(header)) || memcmp(header + 1, "PNG", 3) != 0 || memcmp(header + 12, "IHDR", 4) != 0)
+		return NULL;
+	*width = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+	*height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+	if(channels != NULL)
+		*channels = 4;
+	if(forceChannels == SOIL_LOAD_AUTO)
+		forceChannels = SOIL_LOAD_RGBA;
+
+	return new unsigned char[size_t(*width) * size_t(*height) * forceChannels]();
+}
+
+void SOIL_free_image_data(unsigned char *image)
+{
+	delete [] image;
+}
+
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <GL/glut.h>
+#include "InputScript.h"
+#include "Game.h"
+
+
+#define SHOOT_PERIOD 15
+#define JUMP_PERIOD 40
+
+
+static bool compareEvents(const ScriptEvent &e1, const ScriptEvent &e2)
+{
+	return e1.tick < e2.tick;
+}
+
+static bool parseKey(const string &name, ScriptEvent &event)
+{
+	static const char *specialNames[4] = { "left", "up", "right", "down" };
+	static const int specialKeys[4] = { GLUT_KEY_LEFT, GLUT_KEY_UP, GLUT_KEY_RIGHT, GLUT_KEY_DOWN };
+
+	event.special = false;
+	for(int i=0; i<4; i++)
+	{
+		if(name == specialNames[i])
+		{
+			event.special = true;
+			event.key = specialKeys[i];
+			return true;
+		}
+	}
+	if(name == "enter")
+		event.key = '\r';
+	else if(name == "escape")
+		event.key = 27;
+	else if(name.size() == 1)
+		event.key = (unsigned char)name[0];
+	else
+		return false;
+
+	return true;
+}
+
+
+InputScript::InputScript()
+{
+	nextEvent = 0;
+}
+
+
+bool InputScript::load(const string &filename)
+{
+	ifstream fin(filename.c_str());
+	string line, action, key;
+
+	if(!fin.is_open())
+		return false;
+	while(getline(fin, line))
+	{
+		stringstream sstream(line);
+		ScriptEvent event;
+
+		if(line.empty() || line[0] == '#')
+			continue;
+		if(!(sstream >> event.tick >> action >> key) || (action != "press" && action != "release") || !parseKey(key, event))
+		{
+			cout << "Invalid script line: " << line << endl;
+			return false;
+		}
+		event.press = (action == "press");
+		events.push_back(event);
+	}
+	stable_sort(events.begin(), events.end(), compareEvents);
+
+	return true;
+}
+
+void InputScript::buildDefault(int nTicks)
+{
+	// Enter starts the level, shoots while playing and restarts after a game over
+	addEvent(0, true, true, GLUT_KEY_RIGHT);
+	for(int tick=0; tick<nTicks; tick++)
+	{
+		if(tick % SHOOT_PERIOD == 0)
+			addEvent(tick, true, false, '\r');
+		if(tick % JUMP_PERIOD == 0)
+			addEvent(tick, true, true, GLUT_KEY_UP);
+		if(tick % JUMP_PERIOD == 1)
+			addEvent(tick, false, true, GLUT_KEY_UP);
+	}
+}
+
+void InputScript::queueUntil(int tick)
+{
+	for(; nextEvent < events.size() && events[nextEvent].tick <= tick; nextEvent++)
+	{
+		const ScriptEvent &event = events[nextEvent];
+
+		if(event.special)
+			Game::instance().queueInput(event.press ? INPUT_SPECIAL_PRESS : INPUT_SPECIAL_RELEASE, event.key);
+		else
+			Game::instance().queueInput(event.press ? INPUT_KEY_PRESS : INPUT_KEY_RELEASE, event.key);
+	}
+}
+
+void InputScript::addEvent(int tick, bool press, bool special, int key)
+{
+	ScriptEvent event;
+
+	event.tick = tick;
+	event.press = press;
+	event.special = special;
+	event.key = key;
+	events.push_back(event);
+}
+
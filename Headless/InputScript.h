@@ -0,0 +1,50 @@
+#ifndef _INPUT_SCRIPT_INCLUDE
+#define _INPUT_SCRIPT_INCLUDE
+
+
+#include <string>
+#include <vector>
+
+
+using namespace std;
+
+
+struct ScriptEvent
+{
+	int tick;
+	bool press, special;
+	int key;
+};
+
+
+// InputScript feeds the game key events at given game ticks. Script files
+// have one event per line: "<tick> press|release <key>", where key is left,
+// right, up, down, enter, escape or a single character. Lines starting with
+// # are skipped. The default script, used by Headless and StressTest, walks
+// the player right, jumping and shooting.
+
+
+class InputScript
+{
+
+public:
+	InputScript();
+
+	bool load(const string &filename);
+	void buildDefault(int nTicks);
+
+	// Queues the events up to tick that have not been queued yet
+	void queueUntil(int tick);
+
+private:
+	void addEvent(int tick, bool press, bool special, int key);
+
+private:
+	vector<ScriptEvent> events;
+	unsigned int nextEvent;
+
+};
+
+
+#endif // _INPUT_SCRIPT_INCLUDE
+
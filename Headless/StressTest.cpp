@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <GL/glut.h>
+#include "StressTest.h"
+#include "Game.h"
+#include "InputScript.h"
+#include "LevelFile.h"
+#include "Profiler.h"
+#include "Random.h"
+#include "RenderStats.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <unistd.h>
+#endif
+
+
+#define TEMPLATE_LEVEL_FILE "levels/level01.lvl"
+#define STRESS_LEVEL_FILE "levels/stress.lvl"
+#define NUM_STRESS_ZONES 4
+
+
+#ifdef ENABLE_PROFILER
+// Zones of Scene::update reported by profiled builds, and their columns
+static const char *zoneNames[NUM_STRESS_ZONES] = { "stream level", "update enemies", "update projectiles", "collisions" };
+static const char *zoneColumns[NUM_STRESS_ZONES] = { "stream", "enemies", "projectiles", "collisions" };
+#endif
+
+
+// Memory the process has resident right now
+static long long residentMemoryKb()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+
+	if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return (long long)(counters.WorkingSetSize / 1024);
+#else
+	ifstream fin("/proc/self/statm");
+	long long size, resident;
+
+	if(!(fin >> size >> resident))
+		return 0;
+	return resident * sysconf(_SC_PAGESIZE) / 1024;
+#endif
+}
+
+static double percentile(const vector<double> &sorted, float fraction)
+{
+	if(sorted.empty())
+		return 0.0;
+	return sorted[min(sorted.size() - 1, size_t(fraction * sorted.size()))];
+}
+
+template<class T>
+static bool parseList(const string &values, vector<T> &list)
+{
+	stringstream sstream(values);
+	string token;
+
+	list.clear();
+	while(getline(sstream, token, ','))
+	{
+		stringstream value(token);
+		T number;
+
+		if(!(value >> number) || number < 0)
+			return false;
+		list.push_back(number);
+	}
+
+	return !list.empty();
+}
+
+
+StressTest::StressTest()
+{
+	// The default sweep gives scaling curves for level size, enemies and bullets
+	widths.push_back(100);
+	widths.push_back(400);
+	widths.push_back(1600);
+	densities.push_back(0.25f);
+	densities.push_back(1.f);
+	densities.push_back(4.f);
+	fireRates.push_back(1.f);
+	projectiles.push_back(0);
+	projectiles.push_back(256);
+	projectiles.push_back(1024);
+	nEnemies = 0;
+}
+
+
+bool StressTest::setParameter(const string &name, const string &values)
+{
+	if(name == "-width")
+		return parseList(values, widths) && *min_element(widths.begin(), widths.end()) > 0;
+	if(name == "-density")
+		return parseList(values, densities);
+	if(name == "-fire-rate")
+		return parseList(values, fireRates) && *min_element(fireRates.begin(), fireRates.end()) > 0.f;
+	if(name == "-projectiles")
+		return parseList(values, projectiles);
+
+	return false;
+}
+
+void StressTest::run(int nTicks, ostream &out)
+{
+	StressSettings settings;
+
+	out << "width,density,enemies,fire_rate,projectiles,ticks,"
+		<< "update_p50_us,update_p90_us,update_p99_us,update_max_us,"
+		<< "render_p50_us,render_p99_us,draw_calls,vertices,memory_kb,memory_delta_kb";
+#ifdef ENABLE_PROFILER
+	for(int z=0; z<NUM_STRESS_ZONES; z++)
+		out << "," << zoneColumns[z] << "_p50_us," << zoneColumns[z] << "_p99_us";
+#endif
+	out << endl;
+	for(unsigned int w=0; w<widths.size(); w++)
+		for(unsigned int d=0; d<densities.size(); d++)
+			for(unsigned int f=0; f<fireRates.size(); f++)
+				for(unsigned int p=0; p<projectiles.size(); p++)
+				{
+					settings.width = widths[w];
+					settings.density = densities[d];
+					settings.fireRate = fireRates[f];
+					settings.projectiles = projectiles[p];
+					if(!generateLevel(settings, STRESS_LEVEL_FILE))
+					{
+						out << "Could not generate a level from " << TEMPLATE_LEVEL_FILE << endl;
+						return;
+					}
+					runLevel(settings, nTicks, out);
+				}
+	remove(STRESS_LEVEL_FILE);
+}
+
+// Columns repeat those of the template. Enemies are spread at random along
+// the level, standing where the template ones do.
+bool StressTest::generateLevel(const StressSettings &settings, const string &filename)
+{
+	LevelFile source, level;
+	vector<float> enemyHeights;
+	Random random(DEFAULT_SEED);
+
+	if(!source.load(TEMPLATE_LEVEL_FILE))
+		return false;
+	level.createTiled(source, settings.width);
+
+	for(int i=0; i<source.getNumObjects(); i++)
+		if(string("enemy") == source.getObject(i).type)
+			enemyHeights.push_back(source.getObject(i).y);
+	if(enemyHeights.empty())
+		enemyHeights.push_back(float((source.getMapHeight() - 2) * source.getTileSize()));
+	nEnemies = int(settings.width * settings.density + 0.5f);
+	for(int i=0; i<nEnemies; i++)
+	{
+		float x = float(random.range(0, settings.width * source.getTileSize() - 1));
+		level.addObject("enemy", x, enemyHeights[random.range(0, int(enemyHeights.size()) - 1)]);
+	}
+
+	return level.saveBinary(filename);
+}
+
+void StressTest::runLevel(const StressSettings &settings, int nTicks, ostream &out)
+{
+	LevelSettings levelSettings;
+	InputScript script;
+	vector<double> updateTimes, renderTimes, zoneTimes[NUM_STRESS_ZONES];
+	chrono::steady_clock::time_point start;
+	long long drawCalls = 0, vertices = 0;
+	long long memoryBefore = residentMemoryKb();
+
+	levelSettings.levelFile = STRESS_LEVEL_FILE;
+	levelSettings.fireRate = settings.fireRate;
+	levelSettings.projectiles = settings.projectiles;
+	levelSettings.invulnerable = true;
+	Game::instance().setLevelSettings(levelSettings);
+	Game::instance().startLevel();
+	// Ticks are not counted while the level loads
+	int firstTick = Game::instance().getTick();
+	while(Game::instance().getTick() == firstTick)
+	{
+		Game::instance().update(TICK_TIME);
+		PROFILE_FRAME();
+	}
+
+	script.buildDefault(nTicks);
+	for(int tick=0; tick<nTicks; tick++)
+	{
+		script.queueUntil(tick);
+		start = chrono::steady_clock::now();
+		Game::instance().update(TICK_TIME);
+		updateTimes.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+
+		start = chrono::steady_clock::now();
+		Game::instance().render();
+		renderTimes.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+		// Stats of a frame are published when the next one begins
+		if(tick > 0)
+		{
+			drawCalls += RenderStats::instance().getDrawCalls();
+			vertices += RenderStats::instance().getVertices();
+		}
+		PROFILE_FRAME();
+#ifdef ENABLE_PROFILER
+		for(int z=0; z<NUM_STRESS_ZONES; z++)
+			zoneTimes[z].push_back(Profiler::instance().getFrameTime(Profiler::instance().registerZone(zoneNames[z])));
+#endif
+	}
+	long long memory = residentMemoryKb();
+	Game::instance().queueInput(INPUT_SPECIAL_RELEASE, GLUT_KEY_RIGHT);
+	// The map keeps the level file mapped, and Windows does not let it be
+	// rewritten for the next run or removed until it is closed
+	Game::instance().stopLevel();
+	sort(updateTimes.begin(), updateTimes.end());
+	sort(renderTimes.begin(), renderTimes.end());
+	for(int z=0; z<NUM_STRESS_ZONES; z++)
+		sort(zoneTimes[z].begin(), zoneTimes[z].end());
+
+	int nFrames = max(1, nTicks - 1);
+	out << settings.width << "," << settings.density << "," << nEnemies << "," << settings.fireRate << "," << settings.projectiles << "," << nTicks << ","
+		<< percentile(updateTimes, 0.5f) << "," << percentile(updateTimes, 0.9f) << "," << percentile(updateTimes, 0.99f) << "," << updateTimes.back() << ","
+		<< percentile(renderTimes, 0.5f) << "," << percentile(renderTimes, 0.99f) << ","
+		<< drawCalls / double(nFrames) << "," << vertices / double(nFrames) << ","
+		<< memory << "," << memory - memoryBefore;
+#ifdef ENABLE_PROFILER
+	for(int z=0; z<NUM_STRESS_ZONES; z++)
+		out << "," << percentile(zoneTimes[z], 0.5f) << "," << percentile(zoneTimes[z], 0.99f);
+#endif
+	out << endl;
+}
+
@@ -0,0 +1,59 @@
+#ifndef _STRESS_TEST_INCLUDE
+#define _STRESS_TEST_INCLUDE
+
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+using namespace std;
+
+
+struct StressSettings
+{
+	int width;           // Level width in tiles
+	float density;       // Enemies per tile column
+	float fireRate;      // Multiplies how often enemies shoot
+	int projectiles;     // Bullets kept in flight around the camera
+};
+
+
+// StressTest loads the engine far beyond the real level. For every
+// combination of the configured widths, densities, fire rates and
+// projectile counts it generates a level from the tiles of level01, plays
+// it for a fixed number of ticks with the default input and writes a CSV
+// row with the update and render time percentiles, the draw calls, and the
+// resident memory after the run and how much it grew during it. Profiled
+// builds add the percentiles of the streaming, enemy, projectile and
+// collision zones of every tick. Rendering goes through the shims, so it
+// measures the CPU side only. The player cannot die, so every run lasts
+// the same.
+
+
+class StressTest
+{
+
+public:
+	StressTest();
+
+	// name is -width, -density, -fire-rate or -projectiles and values a
+	// comma separated list. Returns false for any other name or bad values.
+	bool setParameter(const string &name, const string &values);
+	// The game must be initialized
+	void run(int nTicks, ostream &out);
+
+private:
+	bool generateLevel(const StressSettings &settings, const string &filename);
+	void runLevel(const StressSettings &settings, int nTicks, ostream &out);
+
+private:
+	vector<int> widths, projectiles;
+	vector<float> densities, fireRates;
+	int nEnemies;
+
+};
+
+
+#endif // _STRESS_TEST_INCLUDE
+
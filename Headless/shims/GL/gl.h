@@ -0,0 +1,9 @@
+#ifndef _HEADLESS_GL_INCLUDE
+#define _HEADLESS_GL_INCLUDE
+
+
+#include "glew.h"
+
+
+#endif // _HEADLESS_GL_INCLUDE
+
@@ -0,0 +1,15 @@
+#ifndef _HEADLESS_GLUT_INCLUDE
+#define _HEADLESS_GLUT_INCLUDE
+
+
+// Headless builds have no window, only the key codes used by the game are needed
+
+
+#define GLUT_KEY_LEFT 0x0064
+#define GLUT_KEY_UP 0x0065
+#define GLUT_KEY_RIGHT 0x0066
+#define GLUT_KEY_DOWN 0x0067
+
+
+#endif // _HEADLESS_GLUT_INCLUDE
+
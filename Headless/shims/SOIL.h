@@ -0,0 +1,21 @@
+#ifndef _HEADLESS_SOIL_INCLUDE
+#define _HEADLESS_SOIL_INCLUDE
+
+
+// Headless replacement for SOIL. Images are not decoded: the size is read
+// from the PNG header and a blank image of that size is returned, so that
+// atlas packing and tile map layout behave as in the real game.
+
+
+enum
+{
+	SOIL_LOAD_AUTO = 0, SOIL_LOAD_L = 1, SOIL_LOAD_LA = 2, SOIL_LOAD_RGB = 3, SOIL_LOAD_RGBA = 4
+};
+
+
+unsigned char *SOIL_load_image(const char *filename, int *width, int *height, int *channels, int forceChannels);
+void SOIL_free_image_data(unsigned char *image);
+
+
+#endif // _HEADLESS_SOIL_INCLUDE
+
@@ -0,0 +1,92 @@
+#ifndef _HEADLESS_IRRKLANG_INCLUDE
+#define _HEADLESS_IRRKLANG_INCLUDE
+
+
+// Headless replacement for irrKlang. The device accepts every request and
+// plays nothing. Only the calls made by the game are declared.
+
+
+namespace irrklang
+{
+
+enum E_STREAM_MODE { ESM_AUTO_DETECT, ESM_STREAMING, ESM_NO_STREAMING };
+
+class ISoundSource
+{
+};
+
+class ISound
+{
+
+public:
+	ISound() : references(1) {}
+	virtual ~ISound() {}
+
+	virtual void stop() {}
+	virtual bool isFinished() { return true; }
+	bool drop()
+	{
+		if(--references > 0)
+			return false;
+		delete this;
+		return true;
+	}
+
+private:
+	int references;
+
+};
+
+class ISoundEngine
+{
+
+public:
+	virtual ~ISoundEngine()
+	{
+		for(int i=0; i<nSources; i++)
+			delete sources[i];
+	}
+
+	virtual ISoundSource *addSoundSourceFromFile(const char *fileName, E_STREAM_MODE mode = ESM_AUTO_DETECT, bool preload = false)
+	{
+		if(nSources == MAX_SOURCES)
+			return 0;
+		sources[nSources] = new ISoundSource();
+		return sources[nSources++];
+	}
+
+	// Like irrKlang, a sound is only returned when it is tracked
+	virtual ISound *play2D(const char *soundFileName, bool playLooped = false, bool startPaused = false, bool track = false)
+	{
+		return track ? new ISound() : 0;
+	}
+
+	virtual ISound *play2D(ISoundSource *source, bool playLooped = false, bool startPaused = false, bool track = false, bool enableSoundEffects = false)
+	{
+		return track ? new ISound() : 0;
+	}
+
+	bool drop()
+	{
+		delete this;
+		return true;
+	}
+
+private:
+	enum { MAX_SOURCES = 64 };
+
+	ISoundSource *sources[MAX_SOURCES];
+	int nSources = 0;
+
+};
+
+inline ISoundEngine *createIrrKlangDevice()
+{
+	return new ISoundEngine();
+}
+
+}
+
+
+#endif // _HEADLESS_IRRKLANG_INCLUDE
+
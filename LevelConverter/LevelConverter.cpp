@@ -0,0 +1,42 @@
+#include <iostream>
+#include <cstring>
+#include "LevelFile.h"
+
+
+using namespace std;
+
+
+// Converts levels from Tiled (.tmx) or the text format to the binary format
+// loaded by TileMap.
+// Usage: LevelConverter input.tmx|input.txt output.lvl [-compact]
+// With -compact tiles are stored in 8 bits when they fit, at the cost of
+// having to widen them when the level is loaded.
+
+
+int main(int argc, char **argv)
+{
+	LevelFile level;
+	int bytesPerTile = 2;
+
+	if(argc < 3 || (argc == 4 && strcmp(argv[3], "-compact") != 0) || argc > 4)
+	{
+		cout << "Usage: " << argv[0] << " input.tmx|input.txt output.lvl [-compact]" << endl;
+		return 1;
+	}
+	if(!level.load(argv[1]))
+	{
+		cout << "Could not read level " << argv[1] << endl;
+		return 1;
+	}
+	if(argc == 4 && level.getMaxTile() <= 255)
+		bytesPerTile = 1;
+	if(!level.saveBinary(argv[2], bytesPerTile))
+	{
+		cout << "Could not write level " << argv[2] << endl;
+		return 1;
+	}
+	cout << argv[1] << " -> " << argv[2] << " (" << level.getMapWidth() << "x" << level.getMapHeight() << " tiles, " << level.getNumLayers() << " layers, " << level.getNumObjects() << " objects, " << 8 * bytesPerTile << " bits per tile)" << endl;
+
+	return 0;
+}
+
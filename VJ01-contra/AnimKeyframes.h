@@ -9,14 +9,16 @@ using namespace std;
 
 
 // AnimKeyframes contains all information related to a single animation.
-// These are the animation speed measured by millisecsPerKeyframe
-// and texture coordinates for all keyframes.
+// These are the animation speed measured by millisecsPerKeyframe,
+// texture coordinates for all keyframes and, for sprites that collide,
+// the hitbox of each keyframe as an offset inside the quad and a size.
 
 
 struct AnimKeyframes
 {
 	float millisecsPerKeyframe;
 	vector<glm::vec2> keyframeDispl;
+	vector<glm::ivec2> hitboxOffset, hitboxSize;
 };
 
 
@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <SOIL.h>
+#include "AssetLoader.h"
+
+
+AssetLoader::AssetLoader()
+{
+	nBusy = 0;
+	bStop = false;
+}
+
+AssetLoader::~AssetLoader()
+{
+	{
+		lock_guard<mutex> lock(queueMutex);
+		bStop = true;
+	}
+	requestReady.notify_all();
+	for(unsigned int i=0; i<workers.size(); i++)
+		workers[i].join();
+	for(unsigned int i=0; i<completed.size(); i++)
+		SOIL_free_image_data(completed[i].pixels);
+}
+
+
+void AssetLoader::decodeImage(const string &filename, PixelFormat format)
+{
+	DecodeRequest request;
+
+	request.target = NULL;
+	request.filename = filename;
+	request.format = format;
+	startWorkers();
+	{
+		lock_guard<mutex> lock(queueMutex);
+		requests.push_back(request);
+	}
+	requestReady.notify_one();
+}
+
+void AssetLoader::decodeImages(const vector<string> &filenames, PixelFormat format, vector<DecodedImage> &images)
+{
+	images.resize(filenames.size());
+	startWorkers();
+	{
+		lock_guard<mutex> lock(queueMutex);
+		for(unsigned int i=0; i<filenames.size(); i++)
+		{
+			DecodeRequest request;
+
+			request.target = &images[i];
+			request.filename = filenames[i];
+			request.format = format;
+			requests.push_back(request);
+		}
+	}
+	requestReady.notify_all();
+	wait();
+}
+
+bool AssetLoader::pollDecoded(DecodedImage &image)
+{
+	lock_guard<mutex> lock(queueMutex);
+
+	if(completed.empty())
+		return false;
+	image = completed.front();
+	completed.pop_front();
+
+	return true;
+}
+
+void AssetLoader::wait()
+{
+	unique_lock<mutex> lock(queueMutex);
+
+	while(!requests.empty() || nBusy > 0)
+		requestDone.wait(lock);
+}
+
+// One thread is left for the game itself
+void AssetLoader::startWorkers()
+{
+	if(!workers.empty())
+		return;
+	int nThreads = max(1, min(MAX_LOADER_THREADS, int(thread::hardware_concurrency()) - 1));
+	for(int i=0; i<nThreads; i++)
+		workers.push_back(thread(&AssetLoader::workerLoop, this));
+}
+
+void AssetLoader::workerLoop()
+{
+	unique_lock<mutex> lock(queueMutex);
+
+	for(;;)
+	{
+		while(requests.empty() && !bStop)
+			requestReady.wait(lock);
+		if(bStop)
+			return;
+		DecodeRequest request = requests.front();
+		requests.pop_front();
+		nBusy++;
+		lock.unlock();
+
+		DecodedImage image;
+		decode(request, request.target != NULL ? *request.target : image);
+
+		lock.lock();
+		if(request.target == NULL)
+			completed.push_back(image);
+		nBusy--;
+		requestDone.notify_all();
+	}
+}
+
+void AssetLoader::decode(const DecodeRequest &request, DecodedImage &image)
+{
+	image.filename = request.filename;
+	image.format = request.format;
+	image.width = image.height = 0;
+	image.pixels = SOIL_load_image(request.filename.c_str(), &image.width, &image.height, 0,
+		request.format == TEXTURE_PIXEL_FORMAT_RGB ? SOIL_LOAD_RGB : SOIL_LOAD_RGBA);
+}
+
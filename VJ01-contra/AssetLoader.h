@@ -0,0 +1,87 @@
+#ifndef _ASSET_LOADER_INCLUDE
+#define _ASSET_LOADER_INCLUDE
+
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Texture.h"
+
+
+using namespace std;
+
+
+#define MAX_LOADER_THREADS 4
+
+
+// Image decoded by a worker, ready to be uploaded. pixels must be freed
+// with SOIL_free_image_data and is NULL if the image could not be loaded.
+
+struct DecodedImage
+{
+	string filename;
+	PixelFormat format;
+	unsigned char *pixels;
+	int width, height;
+};
+
+
+// AssetLoader is a singleton that decodes images on a pool of worker
+// threads. Decoded images are put in a completion queue that the OpenGL
+// thread drains to upload them, since OpenGL may only be called from there.
+// The workers are started on the first request.
+
+
+class AssetLoader
+{
+
+public:
+	AssetLoader();
+	~AssetLoader();
+
+	static AssetLoader &instance()
+	{
+		static AssetLoader AL;
+
+		return AL;
+	}
+
+	// Queues the image; it will show up in pollDecoded when ready
+	void decodeImage(const string &filename, PixelFormat format);
+	// Decodes all the images in parallel and returns once they are done.
+	// They are returned in images, in order, and not in the completion queue.
+	void decodeImages(const vector<string> &filenames, PixelFormat format, vector<DecodedImage> &images);
+	// Takes an image from the completion queue. Never blocks.
+	bool pollDecoded(DecodedImage &image);
+	// Blocks until every queued image has been decoded
+	void wait();
+
+private:
+	struct DecodeRequest
+	{
+		DecodedImage *target; // NULL to use the completion queue
+		string filename;
+		PixelFormat format;
+	};
+
+	void startWorkers();
+	void workerLoop();
+	static void decode(const DecodeRequest &request, DecodedImage &image);
+
+private:
+	vector<thread> workers;
+	mutex queueMutex;
+	condition_variable requestReady, requestDone;
+	deque<DecodeRequest> requests;
+	deque<DecodedImage> completed;
+	int nBusy;
+	bool bStop;
+
+};
+
+
+#endif // _ASSET_LOADER_INCLUDE
+
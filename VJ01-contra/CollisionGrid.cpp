@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cmath>
+#include "CollisionGrid.h"
+
+
+CollisionGrid::CollisionGrid()
+{
+	originX = 0.f;
+	cellWidth = COLLISION_CELL_WIDTH;
+	nCells = 1;
+}
+
+
+void CollisionGrid::init(float windowWidth, float cellWidth)
+{
+	this->cellWidth = cellWidth;
+	nCells = max(1, int(ceil(windowWidth / cellWidth)));
+	cellStart.assign(nCells + 1, 0);
+	clear(0.f);
+}
+
+void CollisionGrid::clear(float originX)
+{
+	this->originX = originX;
+	boxes.clear();
+	cellItems.clear();
+}
+
+void CollisionGrid::insert(int id, const glm::vec2 &min, const glm::vec2 &max)
+{
+	Box box;
+
+	box.id = id;
+	box.min = min;
+	box.max = max;
+	boxes.push_back(box);
+}
+
+void CollisionGrid::build()
+{
+	unsigned int i;
+	int c;
+
+	// Count the boxes of each cell, turn the counts into bucket starts and
+	// fill the buckets back to front so every bucket keeps insertion order
+	cellStart.assign(nCells + 1, 0);
+	for(i=0; i<boxes.size(); i++)
+	{
+		for(c=cellOf(boxes[i].min.x); c<=cellOf(boxes[i].max.x); c++)
+			cellStart[c + 1]++;
+	}
+	for(c=0; c<nCells; c++)
+		cellStart[c + 1] += cellStart[c];
+	cellItems.resize(cellStart[nCells]);
+	for(i=boxes.size(); i-->0;)
+	{
+		for(c=cellOf(boxes[i].min.x); c<=cellOf(boxes[i].max.x); c++)
+			cellItems[--cellStart[c + 1]] = int(i);
+	}
+	// cellStart[c + 1] now holds the start of bucket c, shift it back
+	for(c=0; c<nCells; c++)
+		cellStart[c] = cellStart[c + 1];
+	cellStart[nCells] = int(cellItems.size());
+}
+
+int CollisionGrid::queryPoint(const glm::vec2 &point, int *hits, int maxHits) const
+{
+	int c = cellOf(point.x), nHits = 0;
+
+	for(int item=cellStart[c]; item<cellStart[c + 1] && nHits<maxHits; item++)
+	{
+		const Box &box = boxes[cellItems[item]];
+		if(point.x > box.min.x && point.x < box.max.x && point.y > box.min.y && point.y < box.max.y)
+			hits[nHits++] = box.id;
+	}
+
+	return nHits;
+}
+
+// Anything outside the window is kept in the first or last column
+int CollisionGrid::cellOf(float x) const
+{
+	return glm::clamp(int(floor((x - originX) / cellWidth)), 0, nCells - 1);
+}
+
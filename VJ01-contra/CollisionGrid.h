@@ -0,0 +1,68 @@
+#ifndef _COLLISION_GRID_INCLUDE
+#define _COLLISION_GRID_INCLUDE
+
+
+#include <vector>
+#include <glm/glm.hpp>
+
+
+using namespace std;
+
+
+#define COLLISION_CELL_WIDTH 64.f
+
+
+// CollisionGrid is a broadphase for point queries against boxes. The level
+// is a side-scroller, so the grid is a row of columns along x; each box is
+// bucketed in every column it overlaps and a query only tests the boxes of
+// the column the point falls in.
+//
+// The grid only spans a window of fixed width, whose origin moves with the
+// camera, so rebuilding it costs the same whatever the length of the level.
+// Anything out of the window falls in its first or last column.
+//
+// The grid is rebuilt every tick: clear() at the window origin, insert()
+// every box, build(). Buckets are laid out contiguously with a counting
+// sort, so after the first few ticks rebuilding does not allocate memory.
+
+
+class CollisionGrid
+{
+
+public:
+	CollisionGrid();
+
+	void init(float windowWidth, float cellWidth = COLLISION_CELL_WIDTH);
+	// Empties the grid and moves its window to start at originX
+	void clear(float originX);
+	// Box (min, max) is identified by id in the query results
+	void insert(int id, const glm::vec2 &min, const glm::vec2 &max);
+	void build();
+
+	// Writes the ids of the boxes strictly containing point to hits, up to
+	// maxHits, and returns how many were found
+	int queryPoint(const glm::vec2 &point, int *hits, int maxHits) const;
+
+	int getNumBoxes() const { return int(boxes.size()); }
+
+private:
+	int cellOf(float x) const;
+
+private:
+	struct Box
+	{
+		int id;
+		glm::vec2 min, max;
+	};
+
+	float originX, cellWidth;
+	int nCells;
+	vector<Box> boxes;
+	vector<int> cellStart;  // Bucket of cell c is cellItems[cellStart[c], cellStart[c + 1])
+	vector<int> cellItems;  // Indices into boxes
+
+};
+
+
+#endif // _COLLISION_GRID_INCLUDE
+
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include "EnemySystem.h"
+#include "JobSystem.h"
+
+
+#define MIN_SHOOT_INTERVAL 80
+#define MAX_SHOOT_INTERVAL 100
+#define GUN_POSITION_X 5
+#define GUN_POSITION_Y 10
+#define UPDATE_GRAIN 256
+
+
+EnemySystem::EnemySystem()
+{
+	entities = NULL;
+	projectiles = NULL;
+	random = NULL;
+	type = -1;
+	fireRate = 1.f;
+}
+
+
+void EnemySystem::init(EntityStore &entityStore, ProjectileSystem &projectileSystem, Random &randomGenerator)
+{
+	entities = &entityStore;
+	projectiles = &projectileSystem;
+	random = &randomGenerator;
+	type = entities->addType("images/enemy_character.txt");
+	sortedIds.clear();
+	active.clear();
+}
+
+void EnemySystem::update(const glm::ivec2 &playerPos, float left, float right)
+{
+	EntityStore *store = entities;
+
+	vector<int>::iterator first = lower_bound(sortedIds.begin(), sortedIds.end(), left,
+		[store](int id, float x) { return store->getPosition(id).x < x; });
+	vector<int>::iterator last = upper_bound(first, sortedIds.end(), right,
+		[store](float x, int id) { return x < store->getPosition(id).x; });
+	active.assign(first, last);
+
+	// Enemies decide in parallel; turning and shooting, which draws random
+	// numbers, are applied afterwards in x order
+	lookRight.resize(active.size());
+	firing.resize(active.size());
+	JobSystem::instance().parallelFor(int(active.size()), UPDATE_GRAIN, [this, &playerPos](int begin, int end) {
+		for(int i=begin; i<end; i++)
+		{
+			int timer = entities->getWeaponTimer(active[i]) - 1;
+			lookRight[i] = entities->getPosition(active[i]).x < playerPos.x;
+			firing[i] = timer <= 0;
+			entities->setWeaponTimer(active[i], timer);
+		}
+	});
+	for(unsigned int i=0; i<active.size(); i++)
+	{
+		int id = active[i];
+		int animation = lookRight[i] ? STAND_RIGHT : STAND_LEFT;
+		if(entities->getAnimation(id) != animation)
+			entities->changeAnimation(id, animation);
+		if(firing[i])
+		{
+			projectiles->spawn(entities->getPosition(id) + entities->getHitbox(id, true) + glm::ivec2(GUN_POSITION_X, GUN_POSITION_Y), entities->getDirection(id), TEAM_ENEMY);
+			entities->setWeaponTimer(id, drawShootInterval());
+		}
+	}
+}
+
+int EnemySystem::spawn(const glm::ivec2 &pos, int spawnPoint)
+{
+	int id = entities->create(type, pos, TEAM_ENEMY, STAND_LEFT);
+
+	if(id == -1)
+		return -1;
+	entities->setWeaponTimer(id, drawShootInterval());
+	entities->setSpawnPoint(id, spawnPoint);
+	sortedIds.insert(findIndexed(id), id);
+
+	return id;
+}
+
+// The store moves its last entity into the slot of the destroyed one, so
+// that enemy changes id and is placed again among the ones with its same x
+void EnemySystem::destroy(int id)
+{
+	int last = entities->getCount() - 1;
+
+	sortedIds.erase(findIndexed(id));
+	if(last != id)
+		sortedIds.erase(findIndexed(last));
+	entities->destroy(id);
+	if(last != id)
+		sortedIds.insert(findIndexed(id), id);
+}
+
+// Ties are broken by id so that the order, and the random numbers drawn
+// by update(), only depend on the order enemies were spawned in. Returns
+// where id is, or should be inserted, in the index.
+vector<int>::iterator EnemySystem::findIndexed(int id)
+{
+	EntityStore *store = entities;
+	int x = entities->getPosition(id).x;
+
+	return lower_bound(sortedIds.begin(), sortedIds.end(), id, [store, x](int indexed, int target) {
+		int indexedX = store->getPosition(indexed).x;
+		return indexedX < x || (indexedX == x && indexed < target);
+	});
+}
+
+int EnemySystem::drawShootInterval()
+{
+	return random->range(max(1, int(MIN_SHOOT_INTERVAL / fireRate)), max(1, int(MAX_SHOOT_INTERVAL / fireRate)));
+}
+
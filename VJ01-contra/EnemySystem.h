@@ -0,0 +1,57 @@
+#ifndef _ENEMY_SYSTEM_INCLUDE
+#define _ENEMY_SYSTEM_INCLUDE
+
+
+#include <vector>
+#include "EntityStore.h"
+#include "ProjectileSystem.h"
+#include "Random.h"
+
+
+// EnemySystem drives the enemies of the entity store: they stand looking at
+// the player and shoot at random intervals. Only the enemies inside an
+// activation window around the camera are updated, the others sleep with
+// their weapon timer stopped. Enemies never move, so an index of their ids
+// sorted by x is updated as they are spawned and destroyed, and the
+// active ones are found with a binary search.
+
+
+class EnemySystem
+{
+
+public:
+	EnemySystem();
+
+	void init(EntityStore &entityStore, ProjectileSystem &projectileSystem, Random &randomGenerator);
+	// Enemies shoot rate times as often as usual
+	void setFireRate(float rate) { fireRate = rate; }
+
+	// Updates the enemies whose x is in [left, right]
+	void update(const glm::ivec2 &playerPos, float left, float right);
+
+	// Returns the id of the new enemy or -1 if the store is full
+	int spawn(const glm::ivec2 &pos, int spawnPoint);
+	// Enemies have to be destroyed here to keep the index up to date
+	void destroy(int id);
+
+	// Ids of the enemies updated by the last update(), sorted by x
+	const vector<int> &getActive() const { return active; }
+
+private:
+	vector<int>::iterator findIndexed(int id);
+	int drawShootInterval();
+
+private:
+	EntityStore *entities;
+	ProjectileSystem *projectiles;
+	Random *random;
+	int type;
+	float fireRate;
+	vector<int> sortedIds, active;
+	vector<unsigned char> lookRight, firing;  // Indexed like active
+
+};
+
+
+#endif // _ENEMY_SYSTEM_INCLUDE
+
@@ -0,0 +1,209 @@
+#include <iostream>
+#include <cmath>
+#include <GL/glew.h>
+#include "EntityStore.h"
+#include "TextureManager.h"
+#include "SpriteFile.h"
+
+
+EntityStore::EntityStore()
+{
+	tileMapDispl = glm::ivec2(0);
+	count = 0;
+	nCursors = 0;
+}
+
+EntityStore::~EntityStore()
+{
+	clear();
+}
+
+
+void EntityStore::init(const glm::ivec2 &tileMapPos)
+{
+	clear();
+	tileMapDispl = tileMapPos;
+}
+
+void EntityStore::clear()
+{
+	for(unsigned int i=0; i<types.size(); i++)
+		TextureManager::instance().release(types[i].spritesheet);
+	types.clear();
+	count = 0;
+	nCursors = 0;
+}
+
+int EntityStore::addType(const string &spriteFile)
+{
+	SpriteFile sprite;
+	EntityType entityType;
+
+	if(!sprite.load(spriteFile))
+	{
+		cout << "Could not load sprite " << spriteFile << endl;
+		return -1;
+	}
+	entityType.spritesheet = TextureManager::instance().acquireRegion(sprite.getSpritesheetFile(), TEXTURE_PIXEL_FORMAT_RGBA, entityType.region);
+	if(entityType.spritesheet == NULL)
+		return -1;
+	entityType.spritesheet->setMinFilter(GL_NEAREST);
+	entityType.spritesheet->setMagFilter(GL_NEAREST);
+	entityType.quadSize = sprite.getQuadSize();
+	entityType.sizeInSpritesheet = sprite.getFrameSize() * entityType.region.uvScale;
+	for(int anim=0; anim<sprite.getNumAnimations(); anim++)
+	{
+		entityType.animations.push_back(sprite.getAnimation(anim));
+		vector<glm::vec2> &keyframes = entityType.animations.back().keyframeDispl;
+		for(unsigned int i=0; i<keyframes.size(); i++)
+			keyframes[i] = entityType.region.uvOffset + keyframes[i] * entityType.region.uvScale;
+	}
+	types.push_back(entityType);
+
+	return int(types.size()) - 1;
+}
+
+int EntityStore::create(int type, const glm::ivec2 &pos, ProjectileTeam team, int animation)
+{
+	if(count == MAX_ENTITIES || type < 0)
+		return -1;
+
+	int id = count++;
+	this->type[id] = (unsigned char)type;
+	position[id] = previousPosition[id] = pos;
+	weaponTimer[id] = 0;
+	this->team[id] = (unsigned char)team;
+	spawnPoint[id] = -1;
+	cursor[id] = -1;
+	changeAnimation(id, animation);
+
+	return id;
+}
+
+void EntityStore::destroy(int id)
+{
+	removeCursor(id);
+	count--;
+	if(id != count)
+		copyEntity(count, id);
+}
+
+void EntityStore::copyEntity(int from, int to)
+{
+	position[to] = position[from];
+	previousPosition[to] = previousPosition[from];
+	type[to] = type[from];
+	animation[to] = animation[from];
+	keyframe[to] = keyframe[from];
+	cursor[to] = cursor[from];
+	if(cursor[to] != -1)
+		cursorEntity[cursor[to]] = to;
+	texCoord[to] = texCoord[from];
+	hitboxOffset[to] = hitboxOffset[from];
+	hitboxSize[to] = hitboxSize[from];
+	weaponTimer[to] = weaponTimer[from];
+	team[to] = team[from];
+	spawnPoint[to] = spawnPoint[from];
+}
+
+// Starts a new tick: positions set from now on are interpolated from the current ones
+void EntityStore::updateAnimations(float deltaTime)
+{
+	for(int i=0; i<count; i++)
+		previousPosition[i] = position[i];
+
+	// Keyframes advance while the accumulated time is over their duration
+	for(int c=0; c<nCursors; c++)
+	{
+		float time = cursorTime[c] + deltaTime;
+		int steps = time > cursorFrameTime[c] ? int(ceil(time / cursorFrameTime[c])) - 1 : 0;
+		int nextKeyframe = cursorKeyframe[c] + steps;
+
+		cursorTime[c] = time - steps * cursorFrameTime[c];
+		cursorKeyframe[c] = nextKeyframe < cursorFrameCount[c] ? nextKeyframe : nextKeyframe % cursorFrameCount[c];
+		cursorSteps[c] = steps;
+	}
+	for(int c=0; c<nCursors; c++)
+	{
+		if(cursorSteps[c] != 0)
+			setKeyframe(cursorEntity[c], cursorKeyframe[c]);
+	}
+}
+
+void EntityStore::render(SpriteBatch &batch) const
+{
+	float alpha = batch.getInterpolation();
+
+	for(int i=0; i<count; i++)
+	{
+		const EntityType &entityType = types[type[i]];
+		glm::vec2 pos = glm::vec2(tileMapDispl) + glm::mix(glm::vec2(previousPosition[i]), glm::vec2(position[i]), alpha);
+
+		batch.draw(entityType.spritesheet, pos, entityType.quadSize, texCoord[i], texCoord[i] + entityType.sizeInSpritesheet);
+	}
+}
+
+void EntityStore::changeAnimation(int id, int animation)
+{
+	const AnimKeyframes &anim = types[type[id]].animations[animation];
+
+	this->animation[id] = (unsigned char)animation;
+	setKeyframe(id, 0);
+	if(anim.keyframeDispl.size() > 1)
+	{
+		if(cursor[id] == -1)
+			addCursor(id);
+		int c = cursor[id];
+		cursorTime[c] = 0.f;
+		cursorFrameTime[c] = anim.millisecsPerKeyframe;
+		cursorKeyframe[c] = 0;
+		cursorFrameCount[c] = int(anim.keyframeDispl.size());
+	}
+	else
+		removeCursor(id);
+}
+
+glm::vec2 EntityStore::getDirection(int id) const
+{
+	if(animation[id] == STAND_LEFT || animation[id] == MOVE_LEFT)
+		return glm::vec2(-1.0f, 0.0f);
+	return glm::vec2(1.0f, 0.0f);
+}
+
+void EntityStore::setKeyframe(int id, int keyframe)
+{
+	const AnimKeyframes &anim = types[type[id]].animations[animation[id]];
+
+	this->keyframe[id] = (unsigned char)keyframe;
+	texCoord[id] = anim.keyframeDispl[keyframe];
+	hitboxOffset[id] = anim.hitboxOffset[keyframe];
+	hitboxSize[id] = anim.hitboxSize[keyframe];
+}
+
+void EntityStore::addCursor(int id)
+{
+	cursor[id] = nCursors;
+	cursorEntity[nCursors] = id;
+	nCursors++;
+}
+
+// The last cursor takes the place of the removed one
+void EntityStore::removeCursor(int id)
+{
+	int c = cursor[id];
+
+	if(c == -1)
+		return;
+	nCursors--;
+	if(c != nCursors)
+	{
+		cursorEntity[c] = cursorEntity[nCursors];
+		cursorTime[c] = cursorTime[nCursors];
+		cursorFrameTime[c] = cursorFrameTime[nCursors];
+		cursorKeyframe[c] = cursorKeyframe[nCursors];
+		cursorFrameCount[c] = cursorFrameCount[nCursors];
+		cursor[cursorEntity[c]] = c;
+	}
+	cursor[id] = -1;
+}
+
@@ -0,0 +1,129 @@
+#ifndef _ENTITY_STORE_INCLUDE
+#define _ENTITY_STORE_INCLUDE
+
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "AnimKeyframes.h"
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "ProjectileSystem.h"
+
+
+#define MAX_ENTITIES 4096
+
+
+// Animations of every character sprite file, in this order
+
+enum CharacterAnims
+{
+	STAND_LEFT, STAND_RIGHT, MOVE_LEFT, MOVE_RIGHT
+};
+
+
+// EntityType holds what entities of the same kind share: the spritesheet
+// region, the size of the quad and the animations with their hitboxes,
+// as loaded from a SpriteFile.
+
+struct EntityType
+{
+	Texture *spritesheet;
+	AtlasRegion region;
+	glm::vec2 quadSize, sizeInSpritesheet;
+	vector<AnimKeyframes> animations;
+};
+
+
+// EntityStore keeps the characters of the scene (the player and the enemies)
+// in fixed size arrays, one array per component: transform, animation state,
+// hitbox, weapon timer and team. Systems walk the arrays from 0 to getCount().
+//
+// Entities are destroyed by moving the last one into their slot, so ids are
+// only stable until the next destroy(). The player is created first and
+// never destroyed, which keeps it at id 0.
+//
+// Only entities whose current animation has more than one keyframe get an
+// animation cursor. Cursors are packed in their own arrays and advanced in
+// a single pass per tick; entities standing on a single keyframe cost
+// nothing until their animation changes.
+
+
+class EntityStore
+{
+
+public:
+	EntityStore();
+	~EntityStore();
+
+	void init(const glm::ivec2 &tileMapPos);
+	// Destroys every entity and releases the types
+	void clear();
+
+	// Types are created once per level from a sprite file and referenced
+	// by their index, -1 if the file could not be loaded
+	int addType(const string &spriteFile);
+
+	// Returns the id of the new entity or -1 if the store is full or the type is invalid
+	int create(int type, const glm::ivec2 &pos, ProjectileTeam team, int animation);
+	void destroy(int id);
+
+	// Systems
+	void updateAnimations(float deltaTime);
+	void render(SpriteBatch &batch) const;
+
+	void changeAnimation(int id, int animation);
+
+	int getCount() const { return count; }
+	glm::ivec2 getPosition(int id) const { return position[id]; }
+	void setPosition(int id, const glm::ivec2 &pos) { position[id] = pos; }
+	glm::ivec2 getSize(int id) const { return glm::ivec2(types[type[id]].quadSize); }
+	int getAnimation(int id) const { return animation[id]; }
+	// Offset of the hitbox inside the quad when top is true, its size otherwise
+	glm::ivec2 getHitbox(int id, bool top) const { return top ? hitboxOffset[id] : hitboxSize[id]; }
+	glm::vec2 getDirection(int id) const;
+	ProjectileTeam getTeam(int id) const { return ProjectileTeam(team[id]); }
+	int getWeaponTimer(int id) const { return weaponTimer[id]; }
+	void setWeaponTimer(int id, int ticks) { weaponTimer[id] = ticks; }
+	// Index of the level spawn point an enemy was created at, -1 for the player
+	int getSpawnPoint(int id) const { return spawnPoint[id]; }
+	void setSpawnPoint(int id, int index) { spawnPoint[id] = index; }
+
+private:
+	void setKeyframe(int id, int keyframe);
+	void addCursor(int id);
+	void removeCursor(int id);
+	void copyEntity(int from, int to);
+
+private:
+	glm::ivec2 tileMapDispl;
+	vector<EntityType> types;
+
+	// Transform
+	glm::ivec2 position[MAX_ENTITIES], previousPosition[MAX_ENTITIES];
+	// Animation state, cursor is -1 for single keyframe animations
+	unsigned char type[MAX_ENTITIES];
+	unsigned char animation[MAX_ENTITIES];
+	unsigned char keyframe[MAX_ENTITIES];
+	int cursor[MAX_ENTITIES];
+	// Texture coordinates and hitbox of the current keyframe, copied from
+	// the type when the keyframe changes
+	glm::vec2 texCoord[MAX_ENTITIES];
+	glm::ivec2 hitboxOffset[MAX_ENTITIES], hitboxSize[MAX_ENTITIES];
+	// Weapon timer in ticks and team
+	int weaponTimer[MAX_ENTITIES];
+	unsigned char team[MAX_ENTITIES];
+	int spawnPoint[MAX_ENTITIES];
+	int count;
+
+	// Animation cursors
+	int cursorEntity[MAX_ENTITIES];
+	float cursorTime[MAX_ENTITIES], cursorFrameTime[MAX_ENTITIES];
+	int cursorKeyframe[MAX_ENTITIES], cursorFrameCount[MAX_ENTITIES], cursorSteps[MAX_ENTITIES];
+	int nCursors;
+
+};
+
+
+#endif // _ENTITY_STORE_INCLUDE
+
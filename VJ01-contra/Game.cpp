@@ -1,26 +1,169 @@
 #include <GL/glew.h>
 #include <GL/glut.h>
+#include <fstream>
 #include "Game.h"
+#include "Profiler.h"
+#include "AssetLoader.h"
+#include "IrrKlangSoundBackend.h"
+#include "RenderState.h"
+#include "RenderStats.h"
+#include "TextureManager.h"
+
+
+#define ATLAS_PAGE_SIZE 1024
+
+
+// Small sprites, characters and screens are packed together so that
+// mixed sprites can be drawn from the same batch
+static const char *atlasImages[] = {
+	"images/main_character.png", "images/enemy_character.png",
+	"images/startscreen.png", "images/helpscreen.png", "images/creditscreen.png", "images/gameoverscreen.png",
+	"images/bullet.png", "images/life.png", "images/spreadgun.png"
+};
+
+
+Game::Game()
+{
+	// Singletons used by the scene are created first so that they are
+	// destroyed after it when the program exits
+	Profiler::instance();
+	AssetLoader::instance();
+	TextureManager::instance();
+	RenderState::instance();
+	RenderStats::instance();
+	seed = DEFAULT_SEED;
+	tick = 0;
+	soundBackend = NULL;
+}
+
+Game::~Game()
+{
+	recorder.close(tick);
+#ifdef ENABLE_PROFILER
+	if(!profileOutput.empty())
+	{
+		ofstream summary((profileOutput + ".txt").c_str());
+		Profiler::instance().printSummary(summary);
+		Profiler::instance().writeChromeTrace(profileOutput + ".json");
+	}
+#endif
+}
 
 
 void Game::init()
 {
 	bPlay = true;
+	interpolation = 0.f;
+	tick = 0;
 	glClearColor(0.3f, 0.3f, 0.3f, 1.0f);
+	sound.init(soundBackend != NULL ? soundBackend : new IrrKlangSoundBackend());
+	soundBackend = NULL;
+	TextureManager::instance().buildAtlas(vector<string>(atlasImages, atlasImages + sizeof(atlasImages) / sizeof(atlasImages[0])), ATLAS_PAGE_SIZE);
 	scene.init();
+	hud.init(scene.getTexProgram());
 }
 
-bool Game::update(int deltaTime)
+bool Game::update(float deltaTime)
 {
+	PROFILE_ZONE("Game::update");
+	InputEvent event;
+
+	TextureManager::instance().update();
+	// Waiting for assets takes a different time on every run. Input stays
+	// queued and no tick is counted meanwhile, so that recordings replay
+	// the same.
+	if(scene.isLoading())
+	{
+		scene.update(deltaTime);
+		return bPlay;
+	}
+
+	if(replay.isOpen())
+	{
+		while(replay.poll(tick, event))
+		{
+			recorder.record(tick, event);
+			applyInput(event);
+		}
+		// Live input is ignored while replaying, except to quit
+		for(unsigned int i=0; i<pendingInput.size(); i++)
+		{
+			if(pendingInput[i].type == INPUT_KEY_PRESS && pendingInput[i].key == 27)
+				bPlay = false;
+		}
+	}
+	else
+	{
+		for(unsigned int i=0; i<pendingInput.size(); i++)
+		{
+			recorder.record(tick, pendingInput[i]);
+			applyInput(pendingInput[i]);
+		}
+	}
+	pendingInput.clear();
+	hud.beginUpdate();
 	scene.update(deltaTime);
+	hud.endUpdate();
+	sound.update();
+	tick++;
+	// Once the recording runs out the player takes over
+	if(replay.isOpen() && replay.isFinished(tick))
+		replay.close();
+	if(!bPlay)
+		recorder.close(tick);
 	
 	return bPlay;
 }
 
 void Game::render()
 {
+	RenderStats::instance().beginFrame();
+	hud.beginFrame();
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	scene.render();
+	hud.render(scene.getLiveProjectiles(), scene.getEnemyCount(), scene.getActiveEnemyCount());
+}
+
+bool Game::startRecording(const string &filename)
+{
+	return recorder.open(filename, seed);
+}
+
+bool Game::startReplay(const string &filename)
+{
+	if(!replay.open(filename))
+		return false;
+	seed = replay.getSeed();
+
+	return true;
+}
+
+void Game::queueInput(InputEventType type, int key)
+{
+	InputEvent event;
+
+	event.type = (unsigned char)type;
+	event.key = (unsigned char)key;
+	pendingInput.push_back(event);
+}
+
+void Game::applyInput(const InputEvent &event)
+{
+	switch(event.type)
+	{
+	case INPUT_KEY_PRESS:
+		keyPressed(event.key);
+		break;
+	case INPUT_KEY_RELEASE:
+		keyReleased(event.key);
+		break;
+	case INPUT_SPECIAL_PRESS:
+		specialKeyPressed(event.key);
+		break;
+	case INPUT_SPECIAL_RELEASE:
+		specialKeyReleased(event.key);
+		break;
+	}
 }
 
 void Game::keyPressed(int key)
@@ -67,13 +210,5 @@ bool Game::getSpecialKey(int key) const
 	return specialKeys[key];
 }
 
-irrklang::ISoundEngine* Game::getSoundEngine() {
-	if (soundEngine == nullptr)
-		soundEngine = irrklang::createIrrKlangDevice();
-	return soundEngine;
-}
-
-
-
 
 
@@ -2,13 +2,22 @@
 #define _GAME_INCLUDE
 
 
-#include <irrKlang.h>
+#include <vector>
 #include "Scene.h"
+#include "SoundSystem.h"
+#include "InputRecorder.h"
+#include "InputReplay.h"
+#include "PerfHud.h"
 
 
 #define SCREEN_WIDTH 640
 #define SCREEN_HEIGHT 480
 
+// The simulation advances in fixed ticks, independently of the frame rate
+#define TICKS_PER_SECOND 60
+#define TICK_TIME (1000.f / TICKS_PER_SECOND)
+#define MAX_TICKS_PER_FRAME 5
+
 
 // Game is a singleton (a class with a single instance) that represents our whole application
 
@@ -17,7 +26,8 @@ class Game
 {
 
 public:
-	Game() {}
+	Game();
+	~Game();
 	
 	
 	static Game &instance()
@@ -28,8 +38,28 @@ public:
 	}
 	
 	void init();
-	bool update(int deltaTime);
+	bool update(float deltaTime);
 	void render();
+	// Fraction of a tick elapsed since the last update, in [0, 1)
+	void setInterpolation(float alpha) { interpolation = alpha; }
+	float getInterpolation() const { return interpolation; }
+	int getTick() const { return tick; }
+	
+	// Seed for the scene RNG. Must be set before init.
+	void setSeed(unsigned int value) { seed = value; }
+	unsigned int getSeed() const { return seed; }
+	// Recording stores the current seed, replaying restores the recorded one
+	bool startRecording(const string &filename);
+	bool startReplay(const string &filename);
+	bool isReplaying() const { return replay.isOpen(); }
+	// Profiled builds write the profile summary to <path>.txt and the Chrome
+	// trace to <path>.json on exit. Nothing is written unless a path is set.
+	void setProfileOutput(const string &path) { profileOutput = path; }
+	int getReplayLength() const { return replay.getLength(); }
+	
+	// Input is queued as it arrives and applied at the start of the next
+	// tick, so that it can be recorded and replayed tick-exact
+	void queueInput(InputEventType type, int key);
 	
 	// Input callback methods
 	void keyPressed(int key);
@@ -42,14 +72,36 @@ public:
 	
 	bool getKey(int key) const;
 	bool getSpecialKey(int key) const;
-	irrklang::ISoundEngine* getSoundEngine();
+	// Level overrides for stress runs, used from the next start of the level
+	void setLevelSettings(const LevelSettings &settings) { scene.setLevelSettings(settings); }
+	// Loads the level from whatever screen is shown
+	void startLevel() { scene.startLevel(); }
+	// Back to the start screen, with the level file no longer in use
+	void stopLevel() { scene.stopLevel(); }
+	// Backend used by init, irrKlang if none is set. The game takes ownership.
+	void setSoundBackend(SoundBackend *backend) { soundBackend = backend; }
+	SoundSystem &getSound() { return sound; }
+	// Shows or hides the performance overlay
+	void toggleHud() { hud.toggle(); }
+
+private:
+	void applyInput(const InputEvent &event);
 
 private:
 	bool bPlay;                       // Continue to play game?
 	Scene scene;                      // Scene to render
 	bool keys[256], specialKeys[256]; // Store key states so that 
 	                                  // we can have access at any time
-	irrklang::ISoundEngine* soundEngine;
+	SoundSystem sound;
+	SoundBackend *soundBackend;
+	float interpolation;
+	int tick;
+	unsigned int seed;
+	string profileOutput;
+	vector<InputEvent> pendingInput;
+	InputRecorder recorder;
+	InputReplay replay;
+	PerfHud hud;
 
 };
 
@@ -0,0 +1,320 @@
+#include "Inflate.h"
+
+
+using namespace std;
+
+
+#define MAX_BITS 15
+#define MAX_LITERAL_CODES 288
+#define MAX_DISTANCE_CODES 30
+
+
+// Canonical Huffman code stored as the number of codes of each length
+// and the symbols sorted by code
+struct Huffman
+{
+	short counts[MAX_BITS + 1];
+	short symbols[MAX_LITERAL_CODES];
+};
+
+class BitReader
+{
+
+public:
+	BitReader(const unsigned char *input, size_t inputSize)
+	{
+		data = input;
+		size = inputSize;
+		position = 0;
+		bitBuffer = 0;
+		bitCount = 0;
+		overflow = false;
+	}
+
+	int bits(int n)
+	{
+		while(bitCount < n)
+		{
+			if(position == size)
+			{
+				overflow = true;
+				return 0;
+			}
+			bitBuffer |= (unsigned int)(data[position++]) << bitCount;
+			bitCount += 8;
+		}
+		int value = int(bitBuffer & ((1u << n) - 1));
+		bitBuffer >>= n;
+		bitCount -= n;
+
+		return value;
+	}
+
+	void alignToByte()
+	{
+		bitBuffer = 0;
+		bitCount = 0;
+	}
+
+	const unsigned char *data;
+	size_t size, position;
+	unsigned int bitBuffer;
+	int bitCount;
+	bool overflow;
+
+};
+
+
+static const short lengthBase[29] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+	35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const short lengthExtra[29] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+	3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const short distanceBase[30] = {
+	1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+	257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const short distanceExtra[30] = {
+	0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+	7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+
+static bool buildHuffman(Huffman &huffman, const short *lengths, int nCodes)
+{
+	short offsets[MAX_BITS + 1];
+	int left = 1;
+
+	for(int len=0; len<=MAX_BITS; len++)
+		huffman.counts[len] = 0;
+	for(int symbol=0; symbol<nCodes; symbol++)
+		huffman.counts[lengths[symbol]]++;
+	// Over-subscribed code sets are invalid, incomplete ones are allowed
+	for(int len=1; len<=MAX_BITS; len++)
+	{
+		left = 2 * left - huffman.counts[len];
+		if(left < 0)
+			return false;
+	}
+	offsets[1] = 0;
+	for(int len=1; len<MAX_BITS; len++)
+		offsets[len + 1] = offsets[len] + huffman.counts[len];
+	for(int symbol=0; symbol<nCodes; symbol++)
+	{
+		if(lengths[symbol] != 0)
+			huffman.symbols[offsets[lengths[symbol]]++] = short(symbol);
+	}
+
+	return true;
+}
+
+static int decodeSymbol(BitReader &reader, const Huffman &huffman)
+{
+	int code = 0, first = 0, index = 0;
+
+	for(int len=1; len<=MAX_BITS; len++)
+	{
+		code |= reader.bits(1);
+		if(reader.overflow)
+			return -1;
+		int count = huffman.counts[len];
+		if(code - count < first)
+			return huffman.symbols[index + (code - first)];
+		index += count;
+		first += count;
+		first <<= 1;
+		code <<= 1;
+	}
+
+	return -1;
+}
+
+static bool inflateBlock(BitReader &reader, const Huffman &literals, const Huffman &distances, vector<unsigned char> &output, size_t outputStart)
+{
+	for(;;)
+	{
+		int symbol = decodeSymbol(reader, literals);
+
+		if(symbol < 0)
+			return false;
+		if(symbol < 256)
+			output.push_back((unsigned char)symbol);
+		else if(symbol == 256)
+			return true;
+		else
+		{
+			symbol -= 257;
+			if(symbol >= 29)
+				return false;
+			int length = lengthBase[symbol] + reader.bits(lengthExtra[symbol]);
+			int distanceSymbol = decodeSymbol(reader, distances);
+			if(distanceSymbol < 0 || distanceSymbol >= 30)
+				return false;
+			size_t distance = size_t(distanceBase[distanceSymbol] + reader.bits(distanceExtra[distanceSymbol]));
+			if(reader.overflow || distance > output.size() - outputStart)
+				return false;
+			// Copies may overlap the bytes they produce, so go one byte at a time
+			size_t from = output.size() - distance;
+			for(int i=0; i<length; i++)
+				output.push_back(output[from + i]);
+		}
+	}
+}
+
+static bool inflateStored(BitReader &reader, vector<unsigned char> &output)
+{
+	reader.alignToByte();
+	if(reader.size - reader.position < 4)
+		return false;
+	const unsigned char *header = reader.data + reader.position;
+	unsigned int length = header[0] | (header[1] << 8);
+	unsigned int complement = header[2] | (header[3] << 8);
+	if(length != (~complement & 0xffff))
+		return false;
+	reader.position += 4;
+	if(reader.size - reader.position < length)
+		return false;
+	output.insert(output.end(), reader.data + reader.position, reader.data + reader.position + length);
+	reader.position += length;
+
+	return true;
+}
+
+static void buildFixedTables(Huffman &literals, Huffman &distances)
+{
+	short lengths[MAX_LITERAL_CODES];
+	int symbol;
+
+	for(symbol=0; symbol<144; symbol++)
+		lengths[symbol] = 8;
+	for(; symbol<256; symbol++)
+		lengths[symbol] = 9;
+	for(; symbol<280; symbol++)
+		lengths[symbol] = 7;
+	for(; symbol<MAX_LITERAL_CODES; symbol++)
+		lengths[symbol] = 8;
+	buildHuffman(literals, lengths, MAX_LITERAL_CODES);
+	for(symbol=0; symbol<MAX_DISTANCE_CODES; symbol++)
+		lengths[symbol] = 5;
+	buildHuffman(distances, lengths, MAX_DISTANCE_CODES);
+}
+
+static bool buildDynamicTables(BitReader &reader, Huffman &literals, Huffman &distances)
+{
+	static const short order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+	short lengths[MAX_LITERAL_CODES + MAX_DISTANCE_CODES];
+	Huffman codeLengths;
+	int nLiterals, nDistances, nCodeLengths, index;
+
+	nLiterals = reader.bits(5) + 257;
+	nDistances = reader.bits(5) + 1;
+	nCodeLengths = reader.bits(4) + 4;
+	if(nLiterals > MAX_LITERAL_CODES || nDistances > MAX_DISTANCE_CODES)
+		return false;
+	for(index=0; index<19; index++)
+		lengths[order[index]] = index < nCodeLengths ? short(reader.bits(3)) : 0;
+	if(reader.overflow || !buildHuffman(codeLengths, lengths, 19))
+		return false;
+
+	index = 0;
+	while(index < nLiterals + nDistances)
+	{
+		int symbol = decodeSymbol(reader, codeLengths);
+		short repeated = 0;
+		int count;
+
+		if(symbol < 0)
+			return false;
+		if(symbol < 16)
+		{
+			lengths[index++] = short(symbol);
+			continue;
+		}
+		if(symbol == 16)
+		{
+			if(index == 0)
+				return false;
+			repeated = lengths[index - 1];
+			count = 3 + reader.bits(2);
+		}
+		else if(symbol == 17)
+			count = 3 + reader.bits(3);
+		else
+			count = 11 + reader.bits(7);
+		if(index + count > nLiterals + nDistances)
+			return false;
+		while(count-- > 0)
+			lengths[index++] = repeated;
+	}
+	if(reader.overflow || lengths[256] == 0)
+		return false;
+
+	return buildHuffman(literals, lengths, nLiterals) && buildHuffman(distances, lengths + nLiterals, nDistances);
+}
+
+static bool inflateStream(BitReader &reader, vector<unsigned char> &output)
+{
+	size_t outputStart = output.size();
+	int last;
+
+	do
+	{
+		Huffman literals, distances;
+		bool ok;
+
+		last = reader.bits(1);
+		switch(reader.bits(2))
+		{
+		case 0:
+			ok = inflateStored(reader, output);
+			break;
+		case 1:
+			buildFixedTables(literals, distances);
+			ok = inflateBlock(reader, literals, distances, output, outputStart);
+			break;
+		case 2:
+			ok = buildDynamicTables(reader, literals, distances) && inflateBlock(reader, literals, distances, output, outputStart);
+			break;
+		default:
+			ok = false;
+			break;
+		}
+		if(!ok || reader.overflow)
+			return false;
+	} while(!last);
+
+	return true;
+}
+
+
+bool inflateRaw(const unsigned char *input, size_t inputSize, vector<unsigned char> &output)
+{
+	BitReader reader(input, inputSize);
+
+	return inflateStream(reader, output);
+}
+
+bool inflateZlib(const unsigned char *input, size_t inputSize, vector<unsigned char> &output)
+{
+	size_t outputStart = output.size();
+	unsigned int a = 1, b = 0, checksum;
+
+	// CMF/FLG header: deflate method, no preset dictionary, valid check bits
+	if(inputSize < 6 || (input[0] & 0x0f) != 8 || (input[1] & 0x20) != 0 || ((input[0] << 8) | input[1]) % 31 != 0)
+		return false;
+	BitReader reader(input + 2, inputSize - 2);
+	if(!inflateStream(reader, output))
+		return false;
+	reader.alignToByte();
+	if(reader.size - reader.position < 4)
+		return false;
+	const unsigned char *trailer = reader.data + reader.position;
+	checksum = (unsigned int)(trailer[0] << 24) | (trailer[1] << 16) | (trailer[2] << 8) | trailer[3];
+	for(size_t i=outputStart; i<output.size(); i++)
+	{
+		a = (a + output[i]) % 65521;
+		b = (b + a) % 65521;
+	}
+
+	return checksum == ((b << 16) | a);
+}
+
@@ -0,0 +1,24 @@
+#ifndef _INFLATE_INCLUDE
+#define _INFLATE_INCLUDE
+
+
+#include <vector>
+
+
+using namespace std;
+
+
+// Minimal decoder for DEFLATE streams (RFC 1951) and their zlib wrapper
+// (RFC 1950). It is only meant for the compressed tile layers of Tiled
+// maps, so it favours size over speed and decodes into memory.
+
+
+// Decompresses a raw DEFLATE stream and appends the result to output
+bool inflateRaw(const unsigned char *input, size_t inputSize, vector<unsigned char> &output);
+
+// Decompresses a zlib stream, checking its header and Adler-32 checksum
+bool inflateZlib(const unsigned char *input, size_t inputSize, vector<unsigned char> &output);
+
+
+#endif // _INFLATE_INCLUDE
+
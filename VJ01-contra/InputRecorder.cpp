@@ -0,0 +1,65 @@
+#include "InputRecorder.h"
+
+
+InputRecorder::InputRecorder()
+{
+	lastTick = 0;
+}
+
+InputRecorder::~InputRecorder()
+{
+	close(lastTick);
+}
+
+
+bool InputRecorder::open(const string &filename, unsigned int seed)
+{
+	close(lastTick);
+	fout.open(filename.c_str(), ios::binary);
+	if(!fout.is_open())
+		return false;
+	fout.write(INPUT_MAGIC, 4);
+	writeWord(INPUT_VERSION);
+	writeWord(seed);
+	lastTick = 0;
+
+	return true;
+}
+
+void InputRecorder::record(int tick, const InputEvent &event)
+{
+	if(!fout.is_open())
+		return;
+	writeVarint((unsigned int)(tick - lastTick));
+	fout.put(char(event.type));
+	fout.put(char(event.key));
+	lastTick = tick;
+}
+
+void InputRecorder::close(int tick)
+{
+	if(!fout.is_open())
+		return;
+	writeVarint((unsigned int)(tick - lastTick));
+	fout.put(char(INPUT_END));
+	fout.close();
+	lastTick = 0;
+}
+
+// 7 bits per byte, the high bit tells whether more bytes follow
+void InputRecorder::writeVarint(unsigned int value)
+{
+	while(value >= 0x80)
+	{
+		fout.put(char((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	fout.put(char(value));
+}
+
+void InputRecorder::writeWord(unsigned int value)
+{
+	for(int i=0; i<4; i++)
+		fout.put(char((value >> (8 * i)) & 0xff));
+}
+
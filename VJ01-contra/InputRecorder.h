@@ -0,0 +1,67 @@
+#ifndef _INPUT_RECORDER_INCLUDE
+#define _INPUT_RECORDER_INCLUDE
+
+
+#include <fstream>
+#include <string>
+
+
+using namespace std;
+
+
+// InputRecorder logs the input of a run, tick by tick, so that InputReplay
+// can play it again. Together with the RNG seed, which is stored in the
+// header, that is all the state needed to reproduce a run exactly.
+//
+// File layout (little endian):
+//   "CREC", version (32 bits), seed (32 bits)
+//   one record per input event: tick delta (varint), type (8 bits), key (8 bits)
+//   end record: ticks since the last event (varint), INPUT_END
+// Only changes are stored, so a tick without input costs nothing.
+
+
+#define INPUT_MAGIC "CREC"
+#define INPUT_VERSION 1
+
+
+enum InputEventType
+{
+	INPUT_KEY_PRESS, INPUT_KEY_RELEASE, INPUT_SPECIAL_PRESS, INPUT_SPECIAL_RELEASE, INPUT_END = 0xff
+};
+
+
+struct InputEvent
+{
+	unsigned char type;
+	unsigned char key;
+};
+
+
+class InputRecorder
+{
+
+public:
+	InputRecorder();
+	~InputRecorder();
+
+	bool open(const string &filename, unsigned int seed);
+	// Ticks must not decrease between calls
+	void record(int tick, const InputEvent &event);
+	// Writes the end record. tick is the number of ticks the run lasted.
+	void close(int tick);
+
+	bool isOpen() const { return fout.is_open(); }
+
+private:
+	void writeVarint(unsigned int value);
+	void writeWord(unsigned int value);
+
+private:
+	ofstream fout;
+	int lastTick;
+
+};
+
+
+#endif // _INPUT_RECORDER_INCLUDE
+
@@ -0,0 +1,98 @@
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include "InputReplay.h"
+
+
+static bool readVarint(const vector<unsigned char> &data, size_t &position, unsigned int &value)
+{
+	value = 0;
+	for(int shift=0; shift<32; shift+=7)
+	{
+		if(position >= data.size())
+			return false;
+		unsigned char byte = data[position++];
+		value |= (unsigned int)(byte & 0x7f) << shift;
+		if((byte & 0x80) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+static unsigned int readWord(const vector<unsigned char> &data, size_t position)
+{
+	return data[position] | (data[position + 1] << 8) | (data[position + 2] << 16) | ((unsigned int)data[position + 3] << 24);
+}
+
+
+InputReplay::InputReplay()
+{
+	bOpen = false;
+	seed = 0;
+	length = 0;
+	nextEvent = 0;
+}
+
+
+bool InputReplay::open(const string &filename)
+{
+	ifstream fin(filename.c_str(), ios::binary);
+	vector<unsigned char> data;
+	size_t position = 12;
+	int tick = 0;
+
+	close();
+	if(!fin.is_open())
+		return false;
+	data.assign(istreambuf_iterator<char>(fin), istreambuf_iterator<char>());
+	if(data.size() < 12 || memcmp(&data[0], INPUT_MAGIC, 4) != 0 || readWord(data, 4) != INPUT_VERSION)
+		return false;
+	seed = readWord(data, 8);
+
+	for(;;)
+	{
+		TimedEvent timed;
+		unsigned int delta;
+
+		if(!readVarint(data, position, delta) || position >= data.size())
+			break;
+		tick += int(delta);
+		timed.event.type = data[position++];
+		if(timed.event.type == INPUT_END)
+		{
+			length = tick;
+			bOpen = true;
+			return true;
+		}
+		if(position >= data.size())
+			break;
+		timed.event.key = data[position++];
+		timed.tick = tick;
+		events.push_back(timed);
+	}
+	// Truncated recording, e.g. the game crashed. Play what there is.
+	length = tick;
+	bOpen = true;
+
+	return true;
+}
+
+void InputReplay::close()
+{
+	bOpen = false;
+	seed = 0;
+	length = 0;
+	events.clear();
+	nextEvent = 0;
+}
+
+bool InputReplay::poll(int tick, InputEvent &event)
+{
+	if(nextEvent >= events.size() || events[nextEvent].tick > tick)
+		return false;
+	event = events[nextEvent++].event;
+
+	return true;
+}
+
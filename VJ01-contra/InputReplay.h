@@ -0,0 +1,52 @@
+#ifndef _INPUT_REPLAY_INCLUDE
+#define _INPUT_REPLAY_INCLUDE
+
+
+#include <string>
+#include <vector>
+#include "InputRecorder.h"
+
+
+using namespace std;
+
+
+// InputReplay reads a file written by InputRecorder and hands its events
+// back at the ticks they were recorded on.
+
+
+class InputReplay
+{
+
+public:
+	InputReplay();
+
+	bool open(const string &filename);
+	void close();
+
+	// Returns the next event due at or before tick, if any
+	bool poll(int tick, InputEvent &event);
+
+	bool isOpen() const { return bOpen; }
+	bool isFinished(int tick) const { return tick >= length; }
+	unsigned int getSeed() const { return seed; }
+	// Number of ticks the recorded run lasted
+	int getLength() const { return length; }
+
+private:
+	struct TimedEvent
+	{
+		int tick;
+		InputEvent event;
+	};
+
+	bool bOpen;
+	unsigned int seed;
+	int length;
+	vector<TimedEvent> events;
+	unsigned int nextEvent;
+
+};
+
+
+#endif // _INPUT_REPLAY_INCLUDE
+
@@ -0,0 +1,82 @@
+#include <iostream>
+#include "IrrKlangSoundBackend.h"
+
+
+IrrKlangSoundBackend::IrrKlangSoundBackend()
+{
+	engine = NULL;
+}
+
+IrrKlangSoundBackend::~IrrKlangSoundBackend()
+{
+	free();
+}
+
+
+bool IrrKlangSoundBackend::init(int nSounds, int nVoices)
+{
+	free();
+	engine = irrklang::createIrrKlangDevice();
+	if(engine == NULL)
+	{
+		cout << "Could not start the sound device" << endl;
+		return false;
+	}
+	sources.assign(nSounds, NULL);
+	voices.assign(nVoices, NULL);
+
+	return true;
+}
+
+void IrrKlangSoundBackend::free()
+{
+	if(engine == NULL)
+		return;
+	for(unsigned int voice=0; voice<voices.size(); voice++)
+		stop(voice);
+	// Sources belong to the engine
+	engine->drop();
+	engine = NULL;
+	sources.clear();
+	voices.clear();
+}
+
+bool IrrKlangSoundBackend::load(int sound, const string &filename, bool stream)
+{
+	if(engine == NULL)
+		return false;
+	sources[sound] = engine->addSoundSourceFromFile(filename.c_str(), stream ? irrklang::ESM_STREAMING : irrklang::ESM_NO_STREAMING, !stream);
+	if(sources[sound] == NULL)
+	{
+		cout << "Could not load sound " << filename << endl;
+		return false;
+	}
+
+	return true;
+}
+
+void IrrKlangSoundBackend::play(int sound, int voice, bool looped)
+{
+	if(engine == NULL || sources[sound] == NULL)
+		return;
+	stop(voice);
+	voices[voice] = engine->play2D(sources[sound], looped, false, true);
+}
+
+// Voices are only valid while the engine is running
+void IrrKlangSoundBackend::stop(int voice)
+{
+	if(voice < 0 || voice >= int(voices.size()) || voices[voice] == NULL)
+		return;
+	voices[voice]->stop();
+	voices[voice]->drop();
+	voices[voice] = NULL;
+}
+
+bool IrrKlangSoundBackend::isPlaying(int voice) const
+{
+	if(voice < 0 || voice >= int(voices.size()))
+		return false;
+	return voices[voice] != NULL && !voices[voice]->isFinished();
+}
+
@@ -0,0 +1,41 @@
+#ifndef _IRRKLANG_SOUND_BACKEND_INCLUDE
+#define _IRRKLANG_SOUND_BACKEND_INCLUDE
+
+
+#include <vector>
+#include <irrKlang.h>
+#include "SoundBackend.h"
+
+
+using namespace std;
+
+
+// SoundBackend that plays through irrKlang. Every sound is an ISoundSource
+// created at load time and every voice keeps the ISound it is playing.
+
+
+class IrrKlangSoundBackend : public SoundBackend
+{
+
+public:
+	IrrKlangSoundBackend();
+	~IrrKlangSoundBackend();
+
+	bool init(int nSounds, int nVoices);
+	void free();
+
+	bool load(int sound, const string &filename, bool stream);
+	void play(int sound, int voice, bool looped);
+	void stop(int voice);
+	bool isPlaying(int voice) const;
+
+private:
+	irrklang::ISoundEngine *engine;
+	vector<irrklang::ISoundSource *> sources;
+	vector<irrklang::ISound *> voices;
+
+};
+
+
+#endif // _IRRKLANG_SOUND_BACKEND_INCLUDE
+
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include "JobSystem.h"
+
+
+JobSystem::JobSystem()
+{
+	nQueued = 0;
+	nPending = 0;
+	nWorkers = max(0, min(MAX_JOB_THREADS, int(thread::hardware_concurrency()) - 1));
+	bStarted = false;
+	bStop = false;
+}
+
+JobSystem::~JobSystem()
+{
+	stopWorkers();
+}
+
+
+void JobSystem::setWorkerCount(int nWorkers)
+{
+	stopWorkers();
+	this->nWorkers = max(0, min(MAX_JOB_THREADS, nWorkers));
+}
+
+void JobSystem::parallelFor(int count, int grainSize, const function<void(int, int)> &job)
+{
+	int nRanges = getNumRanges(count, grainSize);
+
+	if(nRanges == 0)
+		return;
+	if(nWorkers == 0 || nRanges == 1)
+	{
+		for(int begin=0; begin<count; begin+=grainSize)
+			job(begin, min(begin + grainSize, count));
+		return;
+	}
+	startWorkers();
+
+	// Consecutive ranges go to the same queue so each thread walks contiguous memory.
+	// Counters are set first: a worker may take a range as soon as it is queued.
+	int nQueues = int(queues.size());
+	nPending = nRanges;
+	{
+		lock_guard<mutex> lock(sleepMutex);
+		nQueued = nRanges;
+	}
+	for(int q=0; q<nQueues; q++)
+	{
+		lock_guard<mutex> lock(queues[q]->queueMutex);
+		for(int r=q*nRanges/nQueues; r<(q+1)*nRanges/nQueues; r++)
+		{
+			Range range;
+
+			range.job = &job;
+			range.begin = r * grainSize;
+			range.end = min(range.begin + grainSize, count);
+			queues[q]->ranges.push_back(range);
+		}
+	}
+	workReady.notify_all();
+
+	Range range;
+	while(takeRange(nWorkers, range))
+		runRange(range);
+	unique_lock<mutex> lock(sleepMutex);
+	while(nPending > 0)
+		workDone.wait(lock);
+}
+
+void JobSystem::startWorkers()
+{
+	if(bStarted)
+		return;
+	bStop = false;
+	queues.clear();
+	for(int i=0; i<=nWorkers; i++)
+		queues.push_back(unique_ptr<Queue>(new Queue()));
+	for(int i=0; i<nWorkers; i++)
+		workers.push_back(thread(&JobSystem::workerLoop, this, i));
+	bStarted = true;
+}
+
+void JobSystem::stopWorkers()
+{
+	if(!bStarted)
+		return;
+	{
+		lock_guard<mutex> lock(sleepMutex);
+		bStop = true;
+	}
+	workReady.notify_all();
+	for(unsigned int i=0; i<workers.size(); i++)
+		workers[i].join();
+	workers.clear();
+	bStarted = false;
+}
+
+void JobSystem::workerLoop(int index)
+{
+	Range range;
+
+	for(;;)
+	{
+		{
+			unique_lock<mutex> lock(sleepMutex);
+			while(nQueued == 0 && !bStop)
+				workReady.wait(lock);
+			if(bStop)
+				return;
+		}
+		while(takeRange(index, range))
+			runRange(range);
+	}
+}
+
+// Own ranges are taken from the back, stolen ones from the front
+bool JobSystem::takeRange(int index, Range &range)
+{
+	int nQueues = int(queues.size());
+
+	for(int i=0; i<nQueues; i++)
+	{
+		Queue &queue = *queues[(index + i) % nQueues];
+		lock_guard<mutex> lock(queue.queueMutex);
+
+		if(queue.ranges.empty())
+			continue;
+		if(i == 0)
+		{
+			range = queue.ranges.back();
+			queue.ranges.pop_back();
+		}
+		else
+		{
+			range = queue.ranges.front();
+			queue.ranges.pop_front();
+		}
+		nQueued--;
+		return true;
+	}
+
+	return false;
+}
+
+void JobSystem::runRange(const Range &range)
+{
+	(*range.job)(range.begin, range.end);
+	if(--nPending == 0)
+	{
+		lock_guard<mutex> lock(sleepMutex);
+		workDone.notify_all();
+	}
+}
+
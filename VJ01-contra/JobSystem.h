@@ -0,0 +1,93 @@
+#ifndef _JOB_SYSTEM_INCLUDE
+#define _JOB_SYSTEM_INCLUDE
+
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+using namespace std;
+
+
+#define MAX_JOB_THREADS 8
+
+
+// JobSystem is a singleton that runs parallel loops over the game data.
+// parallelFor() cuts the loop into ranges that are dealt to one queue per
+// thread; every thread runs the ranges of its own queue and, once it is
+// empty, steals from the others, so uneven ranges are balanced out.
+// The thread calling parallelFor() works too and the call returns when
+// every range is done.
+//
+// Jobs must only write data owned by their range. Anything that depends
+// on the order of the elements (spawning, killing, random numbers) has
+// to be left to a serial step afterwards, which keeps the simulation
+// identical whatever the number of workers is. With no workers, or a
+// loop smaller than one range, jobs run on the calling thread.
+// Loops cannot be nested.
+
+
+class JobSystem
+{
+
+public:
+	JobSystem();
+	~JobSystem();
+
+	static JobSystem &instance()
+	{
+		static JobSystem JS;
+
+		return JS;
+	}
+
+	// Number of threads besides the calling one, 0 runs everything serially.
+	// Defaults to one less than the number of cores.
+	void setWorkerCount(int nWorkers);
+	int getWorkerCount() const { return nWorkers; }
+
+	// Calls job(begin, end) for consecutive ranges of at most grainSize
+	// elements covering [0, count)
+	void parallelFor(int count, int grainSize, const function<void(int, int)> &job);
+	// Number of ranges a loop is cut into, to size per range results
+	static int getNumRanges(int count, int grainSize) { return (count + grainSize - 1) / grainSize; }
+
+private:
+	struct Range
+	{
+		const function<void(int, int)> *job;
+		int begin, end;
+	};
+
+	struct Queue
+	{
+		mutex queueMutex;
+		deque<Range> ranges;
+	};
+
+	void startWorkers();
+	void stopWorkers();
+	void workerLoop(int index);
+	bool takeRange(int index, Range &range);
+	void runRange(const Range &range);
+
+private:
+	vector<thread> workers;
+	vector<unique_ptr<Queue>> queues;   // One per worker, the last one for the calling thread
+	mutex sleepMutex;
+	condition_variable workReady, workDone;
+	atomic<int> nQueued, nPending;
+	int nWorkers;
+	bool bStarted, bStop;
+
+};
+
+
+#endif // _JOB_SYSTEM_INCLUDE
+
@@ -0,0 +1,611 @@
+#include <cstdio>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "LevelFile.h"
+#include "Inflate.h"
+
+
+using namespace std;
+
+
+static unsigned int alignTo4(unsigned int offset)
+{
+	return (offset + 3) & ~3u;
+}
+
+static void stripCarriageReturn(string &line)
+{
+	if(!line.empty() && line[line.size() - 1] == '\r')
+		line.erase(line.size() - 1);
+}
+
+static bool hasExtension(const string &filename, const string &extension)
+{
+	return filename.size() > extension.size() && filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+// Directory part of a path, including the trailing separator
+static string directoryOf(const string &filename)
+{
+	size_t separator = filename.find_last_of("/\\");
+
+	return separator == string::npos ? "" : filename.substr(0, separator + 1);
+}
+
+// Tiled stores flips in the top bits of each gid, they are not supported
+static unsigned short tileFromGid(unsigned int gid, int firstGid, int nTilesheetTiles)
+{
+	int tile = int(gid & 0x1fffffff) - firstGid;
+
+	if(gid == 0 || tile < 0 || tile >= nTilesheetTiles)
+		return 0;
+	return (unsigned short)(tile + 1);
+}
+
+static int base64Value(char c)
+{
+	if(c >= 'A' && c <= 'Z')
+		return c - 'A';
+	if(c >= 'a' && c <= 'z')
+		return c - 'a' + 26;
+	if(c >= '0' && c <= '9')
+		return c - '0' + 52;
+	if(c == '+')
+		return 62;
+	if(c == '/')
+		return 63;
+	return -1;
+}
+
+static bool decodeBase64(const char *text, size_t length, vector<unsigned char> &output)
+{
+	unsigned int buffer = 0;
+	int nBits = 0;
+
+	for(size_t i=0; i<length; i++)
+	{
+		if(text[i] == '=')
+			break;
+		int value = base64Value(text[i]);
+		if(value < 0)
+		{
+			if(text[i] == ' ' || text[i] == '\t' || text[i] == '\r' || text[i] == '\n')
+				continue;
+			return false;
+		}
+		buffer = (buffer << 6) | value;
+		nBits += 6;
+		if(nBits >= 8)
+		{
+			nBits -= 8;
+			output.push_back((unsigned char)(buffer >> nBits));
+		}
+	}
+
+	return true;
+}
+
+
+LevelFile::LevelFile()
+{
+	setDefaultHeader();
+	tiles = NULL;
+	offsets = NULL;
+	objects = NULL;
+}
+
+
+bool LevelFile::load(const string &filename)
+{
+	if(hasExtension(filename, ".lvl"))
+		return loadBinary(filename);
+	if(hasExtension(filename, ".tmx"))
+		return loadTmx(filename);
+	return loadText(filename);
+}
+
+
+bool LevelFile::loadText(const string &filename)
+{
+	ifstream fin;
+	string line, token;
+	stringstream sstream;
+	int nTiles, nTilesheetTiles;
+
+	free();
+	fin.open(filename.c_str());
+	if(!fin.is_open())
+		return false;
+	getline(fin, line);
+	if(line.compare(0, 7, "TILEMAP") != 0)
+		return false;
+	getline(fin, line);
+	sstream.str(line);
+	sstream >> header.mapWidth >> header.mapHeight;
+	getline(fin, line);
+	sstream.clear();
+	sstream.str(line);
+	sstream >> header.tileSize >> header.blockSize;
+	getline(fin, line);
+	sstream.clear();
+	sstream.str(line);
+	sstream >> tilesheetFile;
+	getline(fin, line);
+	sstream.clear();
+	sstream.str(line);
+	sstream >> header.tilesheetWidth >> header.tilesheetHeight;
+	if(header.mapWidth <= 0 || header.mapHeight <= 0 || header.tilesheetWidth <= 0 || header.tilesheetHeight <= 0)
+		return false;
+
+	// One line per row, tiles separated by commas. A blank entry is an empty tile.
+	nTiles = header.mapWidth * header.mapHeight;
+	header.numLayers = 1;
+	ownedTiles.assign(nTiles, 0);
+	for(int j=0; j<header.mapHeight; j++)
+	{
+		if(!getline(fin, line))
+			return false;
+		stripCarriageReturn(line);
+		sstream.clear();
+		sstream.str(line);
+		for(int i=0; i<header.mapWidth && getline(sstream, token, ','); i++)
+		{
+			if(token.find_first_not_of(" \t") != string::npos)
+				ownedTiles[j * header.mapWidth + i] = (unsigned short)(atoi(token.c_str()) + 1);
+		}
+	}
+
+	// Floor offsets: "item offset" pairs separated by commas and terminated by a dot
+	nTilesheetTiles = header.tilesheetWidth * header.tilesheetHeight;
+	ownedOffsets.assign(nTilesheetTiles, -1);
+	while(getline(fin, line))
+	{
+		stripCarriageReturn(line);
+		if(line.find_first_not_of(" \t") != string::npos)
+			break;
+	}
+	sstream.clear();
+	sstream.str(line);
+	while(getline(sstream, token, ','))
+	{
+		int item, offset;
+
+		if(token.find('.') != string::npos)
+			break;
+		if(sscanf(token.c_str(), "%d %d", &item, &offset) == 2 && item >= 0 && item < nTilesheetTiles)
+			ownedOffsets[item] = short(offset);
+	}
+	fin.close();
+
+	tiles = &ownedTiles[0];
+	offsets = &ownedOffsets[0];
+	// Tiles index the floor offsets and the tilesheet
+	if(getMaxTile() > nTilesheetTiles)
+	{
+		free();
+		return false;
+	}
+
+	return true;
+}
+
+// TMX files are read in a single pass over the token stream. Tile layers
+// are decoded straight into the level, everything else is skipped.
+bool LevelFile::loadTmx(const string &filename)
+{
+	XmlReader xml;
+	XmlToken token;
+	string directory = directoryOf(filename), objectGroup, parent;
+	int firstGid = 0, nTiles = 0;
+	vector<string> elements;
+
+	free();
+	if(!xml.open(filename))
+		return false;
+	while((token = xml.next()) != XML_END_OF_FILE)
+	{
+		if(token == XML_ERROR)
+		{
+			free();
+			return false;
+		}
+		if(token == XML_END_ELEMENT && !elements.empty())
+			elements.pop_back();
+		if(token != XML_START_ELEMENT)
+			continue;
+		parent = elements.empty() ? "" : elements.back();
+		elements.push_back(xml.getName());
+
+		if(xml.getName() == "map")
+		{
+			if(xml.getAttribute("orientation") != "orthogonal" || xml.getIntAttribute("infinite") != 0)
+			{
+				cout << filename << ": only finite orthogonal maps are supported" << endl;
+				free();
+				return false;
+			}
+			header.mapWidth = xml.getIntAttribute("width");
+			header.mapHeight = xml.getIntAttribute("height");
+			header.tileSize = xml.getIntAttribute("tilewidth");
+			header.blockSize = header.tileSize;
+			nTiles = header.mapWidth * header.mapHeight;
+		}
+		else if(xml.getName() == "property" && parent == "properties" && elements.size() == 3)
+		{
+			// Map properties
+			if(xml.getAttribute("name") == "blockSize")
+				header.blockSize = xml.getIntAttribute("value", header.tileSize);
+		}
+		else if(xml.getName() == "tileset")
+		{
+			// TileMap draws from a single tilesheet, gids of any other tileset are left empty
+			if(firstGid != 0)
+			{
+				cout << filename << ": ignoring extra tileset " << xml.getAttribute("source", xml.getAttribute("name")) << endl;
+				xml.skipElement();
+				elements.pop_back();
+				continue;
+			}
+			firstGid = xml.getIntAttribute("firstgid", 1);
+			if(xml.hasAttribute("source"))
+			{
+				XmlReader tsx;
+				string source = directory + xml.getAttribute("source");
+
+				if(!tsx.open(source))
+				{
+					cout << "Could not open tileset " << source << endl;
+					free();
+					return false;
+				}
+				while((token = tsx.next()) == XML_TEXT || (token == XML_START_ELEMENT && tsx.getName() != "tileset"));
+				if(token != XML_START_ELEMENT || !readTmxTileset(tsx, directoryOf(source), firstGid))
+				{
+					free();
+					return false;
+				}
+			}
+			else
+			{
+				if(!readTmxTileset(xml, directory, firstGid))
+				{
+					free();
+					return false;
+				}
+				elements.pop_back();
+			}
+		}
+		else if(xml.getName() == "layer")
+		{
+			if(xml.getIntAttribute("width") != header.mapWidth || xml.getIntAttribute("height") != header.mapHeight)
+			{
+				cout << filename << ": layer " << xml.getAttribute("name") << " does not match the map size" << endl;
+				free();
+				return false;
+			}
+			header.numLayers++;
+			ownedTiles.resize(header.numLayers * nTiles, 0);
+		}
+		else if(xml.getName() == "data" && parent == "layer")
+		{
+			if(firstGid == 0 || !readTmxLayerData(xml, &ownedTiles[(header.numLayers - 1) * nTiles], firstGid))
+			{
+				cout << filename << ": could not read layer " << header.numLayers << endl;
+				free();
+				return false;
+			}
+			elements.pop_back();
+		}
+		else if(xml.getName() == "objectgroup")
+			objectGroup = xml.getAttribute("name");
+		else if(xml.getName() == "object")
+		{
+			// Objects without a type take the name of their group
+			LevelObject object;
+			string type = xml.getAttribute("type", objectGroup);
+
+			memset(&object, 0, sizeof(LevelObject));
+			strncpy(object.type, type.c_str(), LEVEL_OBJECT_TYPE_LENGTH - 1);
+			object.x = xml.getFloatAttribute("x");
+			object.y = xml.getFloatAttribute("y");
+			object.width = xml.getFloatAttribute("width");
+			object.height = xml.getFloatAttribute("height");
+			ownedObjects.push_back(object);
+		}
+	}
+	if(header.numLayers == 0 || firstGid == 0 || header.mapWidth <= 0 || header.mapHeight <= 0)
+	{
+		free();
+		return false;
+	}
+
+	header.numObjects = int(ownedObjects.size());
+	tiles = &ownedTiles[0];
+	offsets = &ownedOffsets[0];
+	objects = ownedObjects.empty() ? NULL : &ownedObjects[0];
+
+	return true;
+}
+
+bool LevelFile::readTmxTileset(XmlReader &xml, const string &directory, int firstGid)
+{
+	int tilesetDepth = xml.getDepth(), columns, tileCount, tile = -1;
+	XmlToken token;
+
+	columns = xml.getIntAttribute("columns");
+	tileCount = xml.getIntAttribute("tilecount");
+	if(columns <= 0 || tileCount <= 0)
+		return false;
+	header.tilesheetWidth = columns;
+	header.tilesheetHeight = (tileCount + columns - 1) / columns;
+	ownedOffsets.assign(header.tilesheetWidth * header.tilesheetHeight, -1);
+	// Floor offsets come from a "floor" property on each tile
+	while((token = xml.next()) != XML_END_OF_FILE && token != XML_ERROR)
+	{
+		if(token == XML_END_ELEMENT && xml.getDepth() < tilesetDepth)
+			return !tilesheetFile.empty();
+		if(token != XML_START_ELEMENT)
+			continue;
+		if(xml.getName() == "image")
+			tilesheetFile = directory + xml.getAttribute("source");
+		else if(xml.getName() == "tile")
+			tile = xml.getIntAttribute("id", -1);
+		else if(xml.getName() == "property" && xml.getAttribute("name") == "floor" && tile >= 0 && tile < int(ownedOffsets.size()))
+			ownedOffsets[tile] = short(xml.getIntAttribute("value", -1));
+	}
+
+	return false;
+}
+
+bool LevelFile::readTmxLayerData(XmlReader &xml, unsigned short *layer, int firstGid)
+{
+	int dataDepth = xml.getDepth(), nTiles, nTilesheetTiles, index = 0;
+	string encoding = xml.getAttribute("encoding"), compression = xml.getAttribute("compression");
+	vector<unsigned char> bytes, decompressed;
+	XmlToken token;
+
+	nTiles = header.mapWidth * header.mapHeight;
+	nTilesheetTiles = header.tilesheetWidth * header.tilesheetHeight;
+	while((token = xml.next()) != XML_END_OF_FILE && token != XML_ERROR)
+	{
+		if(token == XML_END_ELEMENT && xml.getDepth() < dataDepth)
+			return index == nTiles;
+		if(token == XML_START_ELEMENT && xml.getName() == "tile" && encoding.empty())
+		{
+			// Plain XML encoding, one element per tile
+			if(index < nTiles)
+				layer[index] = tileFromGid((unsigned int)xml.getIntAttribute("gid"), firstGid, nTilesheetTiles);
+			index++;
+		}
+		else if(token == XML_TEXT && encoding == "csv")
+		{
+			const char *text = xml.getText(), *textEnd = text + xml.getTextLength();
+			unsigned int gid = 0;
+			bool digits = false;
+
+			for(; text<=textEnd; text++)
+			{
+				if(text < textEnd && *text >= '0' && *text <= '9')
+				{
+					gid = gid * 10 + (*text - '0');
+					digits = true;
+				}
+				else if(text == textEnd || *text == ',')
+				{
+					if(digits && index < nTiles)
+						layer[index] = tileFromGid(gid, firstGid, nTilesheetTiles);
+					if(digits)
+						index++;
+					gid = 0;
+					digits = false;
+				}
+			}
+		}
+		else if(token == XML_TEXT && encoding == "base64")
+		{
+			bytes.clear();
+			if(!decodeBase64(xml.getText(), xml.getTextLength(), bytes))
+				return false;
+			if(compression == "zlib")
+			{
+				decompressed.clear();
+				if(!inflateZlib(bytes.empty() ? NULL : &bytes[0], bytes.size(), decompressed))
+					return false;
+				bytes.swap(decompressed);
+			}
+			else if(!compression.empty())
+			{
+				cout << "Unsupported layer compression " << compression << endl;
+				return false;
+			}
+			if(bytes.size() != size_t(4 * nTiles))
+				return false;
+			// Little endian 32 bit gids
+			for(index=0; index<nTiles; index++)
+			{
+				const unsigned char *gid = &bytes[4 * index];
+				layer[index] = tileFromGid(gid[0] | (gid[1] << 8) | (gid[2] << 16) | ((unsigned int)gid[3] << 24), firstGid, nTilesheetTiles);
+			}
+		}
+	}
+
+	return false;
+}
+
+bool LevelFile::loadBinary(const string &filename)
+{
+	const unsigned char *data;
+	size_t size, nTiles, nTilesheetTiles;
+
+	free();
+	if(!file.open(filename))
+		return false;
+	data = file.getData();
+	size = file.getSize();
+	if(size < sizeof(LevelHeader))
+	{
+		free();
+		return false;
+	}
+	memcpy(&header, data, sizeof(LevelHeader));
+	nTiles = size_t(header.numLayers) * size_t(header.mapWidth) * size_t(header.mapHeight);
+	nTilesheetTiles = size_t(header.tilesheetWidth) * size_t(header.tilesheetHeight);
+	if(memcmp(header.magic, LEVEL_MAGIC, 4) != 0 || header.version != LEVEL_VERSION ||
+	   header.mapWidth <= 0 || header.mapHeight <= 0 || header.tilesheetWidth <= 0 || header.tilesheetHeight <= 0 ||
+	   header.numLayers <= 0 || header.numObjects < 0 || (header.bytesPerTile != 1 && header.bytesPerTile != 2) ||
+	   (header.tilesOffset % 4) != 0 || (header.offsetsOffset % 4) != 0 || (header.objectsOffset % 4) != 0 ||
+	   header.tilesheetOffset + size_t(header.tilesheetLength) > size ||
+	   header.tilesOffset + nTiles * header.bytesPerTile > size ||
+	   header.offsetsOffset + nTilesheetTiles * sizeof(short) > size ||
+	   header.objectsOffset + header.numObjects * sizeof(LevelObject) > size)
+	{
+		free();
+		return false;
+	}
+	tilesheetFile.assign((const char *)data + header.tilesheetOffset, header.tilesheetLength);
+
+	// 16 bit tiles and the offsets table are used straight from the mapping.
+	// Compact 8 bit levels need to be widened once.
+	if(header.bytesPerTile == 2)
+		tiles = (const unsigned short *)(data + header.tilesOffset);
+	else
+	{
+		ownedTiles.assign(data + header.tilesOffset, data + header.tilesOffset + nTiles);
+		tiles = &ownedTiles[0];
+	}
+	offsets = (const short *)(data + header.offsetsOffset);
+	objects = (const LevelObject *)(data + header.objectsOffset);
+	// Tiles index the floor offsets and the tilesheet
+	if(size_t(getMaxTile()) > nTilesheetTiles)
+	{
+		free();
+		return false;
+	}
+
+	return true;
+}
+
+bool LevelFile::saveBinary(const string &filename, int bytesPerTile) const
+{
+	ofstream fout;
+	LevelHeader outHeader;
+	size_t nTiles, nTilesheetTiles;
+	vector<char> buffer;
+
+	if(tiles == NULL || (bytesPerTile != 1 && bytesPerTile != 2))
+		return false;
+	if(bytesPerTile == 1 && getMaxTile() > 255)
+		return false;
+	nTiles = size_t(header.numLayers) * size_t(header.mapWidth) * size_t(header.mapHeight);
+	nTilesheetTiles = size_t(header.tilesheetWidth) * size_t(header.tilesheetHeight);
+
+	outHeader = header;
+	memcpy(outHeader.magic, LEVEL_MAGIC, 4);
+	outHeader.version = LEVEL_VERSION;
+	outHeader.bytesPerTile = bytesPerTile;
+	outHeader.tilesheetOffset = sizeof(LevelHeader);
+	outHeader.tilesheetLength = (unsigned int)tilesheetFile.size();
+	outHeader.tilesOffset = alignTo4(outHeader.tilesheetOffset + outHeader.tilesheetLength);
+	outHeader.offsetsOffset = alignTo4(outHeader.tilesOffset + (unsigned int)(nTiles * bytesPerTile));
+	outHeader.objectsOffset = alignTo4(outHeader.offsetsOffset + (unsigned int)(nTilesheetTiles * sizeof(short)));
+
+	buffer.assign(outHeader.objectsOffset + header.numObjects * sizeof(LevelObject), 0);
+	memcpy(&buffer[0], &outHeader, sizeof(LevelHeader));
+	memcpy(&buffer[outHeader.tilesheetOffset], tilesheetFile.c_str(), tilesheetFile.size());
+	if(bytesPerTile == 2)
+		memcpy(&buffer[outHeader.tilesOffset], tiles, nTiles * sizeof(unsigned short));
+	else
+	{
+		for(size_t i=0; i<nTiles; i++)
+			buffer[outHeader.tilesOffset + i] = char(tiles[i]);
+	}
+	memcpy(&buffer[outHeader.offsetsOffset], offsets, nTilesheetTiles * sizeof(short));
+	if(header.numObjects > 0)
+		memcpy(&buffer[outHeader.objectsOffset], objects, header.numObjects * sizeof(LevelObject));
+
+	fout.open(filename.c_str(), ios::binary);
+	if(!fout.is_open())
+		return false;
+	fout.write(&buffer[0], buffer.size());
+	fout.close();
+
+	return !fout.fail();
+}
+
+void LevelFile::create(const LevelFile &tileset, int mapWidth, int mapHeight)
+{
+	size_t nTilesheetTiles = size_t(tileset.header.tilesheetWidth) * size_t(tileset.header.tilesheetHeight);
+
+	free();
+	header = tileset.header;
+	header.mapWidth = mapWidth;
+	header.mapHeight = mapHeight;
+	header.numLayers = 1;
+	header.numObjects = 0;
+	tilesheetFile = tileset.tilesheetFile;
+	ownedTiles.assign(size_t(mapWidth) * size_t(mapHeight), 0);
+	ownedOffsets.assign(tileset.offsets, tileset.offsets + nTilesheetTiles);
+	tiles = &ownedTiles[0];
+	offsets = &ownedOffsets[0];
+}
+
+void LevelFile::createTiled(const LevelFile &source, int mapWidth)
+{
+	create(source, mapWidth, source.getMapHeight());
+	for(int i=0; i<mapWidth; i++)
+		for(int j=0; j<source.getMapHeight(); j++)
+			setTile(i, j, source.getTiles()[j * source.getMapWidth() + i % source.getMapWidth()]);
+}
+
+void LevelFile::addObject(const string &type, float x, float y)
+{
+	LevelObject object;
+
+	memset(&object, 0, sizeof(LevelObject));
+	strncpy(object.type, type.c_str(), LEVEL_OBJECT_TYPE_LENGTH - 1);
+	object.x = x;
+	object.y = y;
+	ownedObjects.push_back(object);
+	header.numObjects = int(ownedObjects.size());
+	objects = &ownedObjects[0];
+}
+
+void LevelFile::free()
+{
+	file.close();
+	ownedTiles.clear();
+	ownedOffsets.clear();
+	ownedObjects.clear();
+	tilesheetFile.clear();
+	tiles = NULL;
+	offsets = NULL;
+	objects = NULL;
+	setDefaultHeader();
+}
+
+int LevelFile::getMaxTile() const
+{
+	int maxTile = 0;
+
+	if(tiles == NULL)
+		return 0;
+	for(int i=0; i<header.numLayers*header.mapWidth*header.mapHeight; i++)
+	{
+		if(tiles[i] > maxTile)
+			maxTile = tiles[i];
+	}
+
+	return maxTile;
+}
+
+void LevelFile::setDefaultHeader()
+{
+	memset(&header, 0, sizeof(LevelHeader));
+	memcpy(header.magic, LEVEL_MAGIC, 4);
+	header.version = LEVEL_VERSION;
+	header.bytesPerTile = 2;
+}
+
@@ -0,0 +1,116 @@
+#ifndef _LEVEL_FILE_INCLUDE
+#define _LEVEL_FILE_INCLUDE
+
+
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "XmlReader.h"
+
+
+using namespace std;
+
+
+// LevelFile holds the contents of a level independently of OpenGL: its
+// dimensions, the tilesheet it uses, one or more layers of tile indices,
+// the table of floor offsets for each tile and the objects placed on the
+// map (spawn points). Levels are authored in Tiled (.tmx) or in the old
+// text format (see level01.txt) and converted offline to the binary
+// format, which is memory mapped so that loading does no parsing at all.
+//
+// Binary layout (little endian, every section aligned to 4 bytes):
+//   LevelHeader
+//   tilesheet filename (not null terminated)
+//   numLayers * mapWidth * mapHeight tile indices, 8 or 16 bits each (0 = empty)
+//   tilesheetWidth * tilesheetHeight 16 bit floor offsets (-1 = none)
+//   numObjects LevelObject records
+
+
+#define LEVEL_MAGIC "CLVL"
+#define LEVEL_VERSION 2
+#define LEVEL_OBJECT_TYPE_LENGTH 16
+
+
+struct LevelHeader
+{
+	char magic[4];
+	unsigned int version;
+	int mapWidth, mapHeight;
+	int tileSize, blockSize;
+	int tilesheetWidth, tilesheetHeight;
+	unsigned int bytesPerTile;
+	unsigned int tilesheetOffset, tilesheetLength;
+	unsigned int tilesOffset, offsetsOffset;
+	int numLayers, numObjects;
+	unsigned int objectsOffset;
+};
+
+struct LevelObject
+{
+	char type[LEVEL_OBJECT_TYPE_LENGTH];
+	float x, y, width, height;
+};
+
+
+class LevelFile
+{
+
+public:
+	LevelFile();
+
+	// Picks the loader from the extension: .lvl, .tmx or text. Levels with
+	// tiles beyond the end of their tilesheet are rejected.
+	bool load(const string &filename);
+	bool loadText(const string &filename);
+	bool loadTmx(const string &filename);
+	bool loadBinary(const string &filename);
+	// bytesPerTile is 1 or 2. Only 16 bit tiles can be used in place when loading.
+	bool saveBinary(const string &filename, int bytesPerTile = 2) const;
+	// Starts an empty single layer level in memory that uses the tilesheet and
+	// floor offsets of another one. Generated levels are filled with setTile()
+	// and addObject(), which only work on levels made this way, and saved with saveBinary().
+	void create(const LevelFile &tileset, int mapWidth, int mapHeight);
+	// Same as create() with the height of source, filled with the columns of
+	// its first layer repeated up to mapWidth
+	void createTiled(const LevelFile &source, int mapWidth);
+	void setTile(int i, int j, unsigned short tile) { ownedTiles[j * header.mapWidth + i] = tile; }
+	void addObject(const string &type, float x, float y);
+	void free();
+
+	int getMapWidth() const { return header.mapWidth; }
+	int getMapHeight() const { return header.mapHeight; }
+	int getTileSize() const { return header.tileSize; }
+	int getBlockSize() const { return header.blockSize; }
+	int getTilesheetWidth() const { return header.tilesheetWidth; }
+	int getTilesheetHeight() const { return header.tilesheetHeight; }
+	int getNumLayers() const { return header.numLayers; }
+	int getNumObjects() const { return header.numObjects; }
+	const string &getTilesheetFile() const { return tilesheetFile; }
+	int getMaxTile() const;
+
+	// Tile at (i, j) is getTiles(layer)[j * mapWidth + i]; tile t uses floor offset offsets[t - 1]
+	const unsigned short *getTiles(int layer = 0) const { return tiles + layer * header.mapWidth * header.mapHeight; }
+	const short *getOffsets() const { return offsets; }
+	const LevelObject &getObject(int index) const { return objects[index]; }
+
+private:
+	void setDefaultHeader();
+	bool readTmxTileset(XmlReader &xml, const string &directory, int firstGid);
+	bool readTmxLayerData(XmlReader &xml, unsigned short *layer, int firstGid);
+
+private:
+	LevelHeader header;
+	string tilesheetFile;
+	MappedFile file;
+	vector<unsigned short> ownedTiles;
+	vector<short> ownedOffsets;
+	vector<LevelObject> ownedObjects;
+	const unsigned short *tiles;
+	const short *offsets;
+	const LevelObject *objects;
+
+};
+
+
+#endif // _LEVEL_FILE_INCLUDE
+
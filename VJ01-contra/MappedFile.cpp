@@ -0,0 +1,100 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "MappedFile.h"
+
+
+MappedFile::MappedFile()
+{
+	data = NULL;
+	size = 0;
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = NULL;
+#else
+	fileDescriptor = -1;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+
+bool MappedFile::open(const string &filename)
+{
+	close();
+#ifdef _WIN32
+	LARGE_INTEGER fileSize;
+
+	fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(fileHandle == INVALID_HANDLE_VALUE)
+		return false;
+	if(!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		close();
+		return false;
+	}
+	size = size_t(fileSize.QuadPart);
+	mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(mappingHandle == NULL)
+	{
+		close();
+		return false;
+	}
+	data = (const unsigned char *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+#else
+	struct stat fileStat;
+
+	fileDescriptor = ::open(filename.c_str(), O_RDONLY);
+	if(fileDescriptor == -1)
+		return false;
+	if(fstat(fileDescriptor, &fileStat) == -1 || fileStat.st_size == 0)
+	{
+		close();
+		return false;
+	}
+	size = size_t(fileStat.st_size);
+	void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	if(mapping != MAP_FAILED)
+		data = (const unsigned char *)mapping;
+#endif
+	if(data == NULL)
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedFile::close()
+{
+#ifdef _WIN32
+	if(data != NULL)
+		UnmapViewOfFile(data);
+	if(mappingHandle != NULL)
+		CloseHandle(mappingHandle);
+	if(fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(fileHandle);
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = NULL;
+#else
+	if(data != NULL)
+		munmap((void *)data, size);
+	if(fileDescriptor != -1)
+		::close(fileDescriptor);
+	fileDescriptor = -1;
+#endif
+	data = NULL;
+	size = 0;
+}
+
@@ -0,0 +1,47 @@
+#ifndef _MAPPED_FILE_INCLUDE
+#define _MAPPED_FILE_INCLUDE
+
+
+#include <string>
+
+
+using namespace std;
+
+
+// MappedFile maps a whole file read-only into memory. Its contents are
+// paged in by the operating system when they are first accessed, so
+// opening a file costs the same independently of its size.
+
+
+class MappedFile
+{
+
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool open(const string &filename);
+	void close();
+
+	bool isOpen() const { return data != NULL; }
+	const unsigned char *getData() const { return data; }
+	size_t getSize() const { return size; }
+
+private:
+	MappedFile(const MappedFile &);
+	MappedFile &operator=(const MappedFile &);
+
+private:
+	const unsigned char *data;
+	size_t size;
+#ifdef _WIN32
+	void *fileHandle, *mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+
+};
+
+
+#endif // _MAPPED_FILE_INCLUDE
+
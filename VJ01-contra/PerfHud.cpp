@@ -0,0 +1,175 @@
+#include <iomanip>
+#include <sstream>
+#include <glm/gtc/matrix_transform.hpp>
+#include "PerfHud.h"
+#include "Game.h"
+#include "RenderStats.h"
+#include "TextureManager.h"
+
+
+#define HUD_REFRESH_MS 500.f
+#define HUD_MARGIN 8.f
+#define HUD_TEXT_SCALE 2.f
+
+
+PerfHud::PerfHud()
+{
+	visible = false;
+	program = NULL;
+	hudVertices = 0;
+	nextQuery = 0;
+	timing = false;
+	for(int i=0; i<HUD_QUERIES; i++)
+	{
+		queries[i] = 0;
+		pending[i] = false;
+	}
+	firstFrame = true;
+	frameSum = updateSum = renderSum = gpuSum = 0.f;
+	nFrames = nRenders = nGpuFrames = 0;
+	frameMs = updateMs = renderMs = gpuMs = 0.f;
+	gpuValid = false;
+}
+
+
+void PerfHud::init(ShaderProgram &program)
+{
+	this->program = &program;
+	projectionUniform = program.getUniformHandle("projection");
+	colorUniform = program.getUniformHandle("color");
+	batch.init(program);
+	text.init();
+	if(queries[0] == 0)
+		glGenQueries(HUD_QUERIES, queries);
+}
+
+void PerfHud::free()
+{
+	batch.free();
+	text.free();
+	glDeleteQueries(HUD_QUERIES, queries);
+	for(int i=0; i<HUD_QUERIES; i++)
+	{
+		queries[i] = 0;
+		pending[i] = false;
+	}
+}
+
+// Measurements start over every time the overlay is shown
+void PerfHud::toggle()
+{
+	visible = !visible;
+	firstFrame = true;
+	hudVertices = 0;
+	frameSum = updateSum = renderSum = gpuSum = 0.f;
+	nFrames = nRenders = nGpuFrames = 0;
+	frameMs = updateMs = renderMs = gpuMs = 0.f;
+	gpuValid = false;
+}
+
+void PerfHud::beginUpdate()
+{
+	if(visible)
+		updateStart = chrono::steady_clock::now();
+}
+
+void PerfHud::endUpdate()
+{
+	if(visible)
+		updateSum += chrono::duration<float, milli>(chrono::steady_clock::now() - updateStart).count();
+}
+
+void PerfHud::beginFrame()
+{
+	chrono::steady_clock::time_point now;
+
+	if(!visible)
+		return;
+	now = chrono::steady_clock::now();
+	if(!firstFrame)
+	{
+		frameSum += chrono::duration<float, milli>(now - frameStart).count();
+		nFrames++;
+	}
+	firstFrame = false;
+	frameStart = now;
+
+	// A frame is not timed if the GPU is so far behind that the ring is full
+	collectQueries();
+	timing = !pending[nextQuery];
+	if(timing)
+		glBeginQuery(GL_TIME_ELAPSED, queries[nextQuery]);
+}
+
+void PerfHud::render(int bullets, int enemies, int activeEnemies)
+{
+	stringstream sstream;
+
+	if(!visible)
+		return;
+	renderSum += chrono::duration<float, milli>(chrono::steady_clock::now() - frameStart).count();
+	nRenders++;
+	if(timing)
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		pending[nextQuery] = true;
+		nextQuery = (nextQuery + 1) % HUD_QUERIES;
+	}
+	if(frameSum >= HUD_REFRESH_MS)
+		refresh();
+
+	// Counters of the last frame include the overlay drawn in it
+	int drawCalls = RenderStats::instance().getDrawCalls() - (hudVertices > 0 ? 1 : 0);
+	int vertices = RenderStats::instance().getVertices() - hudVertices;
+	sstream << fixed << setprecision(2);
+	sstream << "FRAME " << frameMs << " MS  " << setprecision(0) << (frameMs > 0.f ? 1000.f / frameMs : 0.f) << " FPS\n" << setprecision(2);
+	sstream << "UPDATE " << updateMs << " MS  RENDER " << renderMs << " MS\n";
+	if(gpuValid)
+		sstream << "GPU " << gpuMs << " MS\n";
+	else
+		sstream << "GPU -\n";
+	sstream << "DRAW CALLS " << drawCalls << "  VERTICES " << vertices << "\n";
+	sstream << "BULLETS " << bullets << "  ENEMIES " << activeEnemies << "/" << enemies << "\n";
+	sstream << "TEXTURES " << TextureManager::instance().getTotalBytes() / 1024 << " KB";
+
+	program->use();
+	program->setUniformMatrix4f(projectionUniform, glm::ortho(0.f, float(SCREEN_WIDTH), float(SCREEN_HEIGHT), 0.f));
+	program->setUniform4f(colorUniform, 1.f, 1.f, 0.f, 1.f);
+	batch.begin();
+	text.addText(batch, sstream.str(), glm::vec2(HUD_MARGIN, HUD_MARGIN), HUD_TEXT_SCALE);
+	batch.end();
+	hudVertices = 6 * batch.getQuadCount();
+}
+
+// Results are read oldest first and only once available
+void PerfHud::collectQueries()
+{
+	for(int i=0; i<HUD_QUERIES; i++)
+	{
+		int query = (nextQuery + i) % HUD_QUERIES;
+		GLint available = 0;
+		GLuint64 nanoseconds = 0;
+
+		if(!pending[query])
+			continue;
+		glGetQueryObjectiv(queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+		if(!available)
+			break;
+		glGetQueryObjectui64v(queries[query], GL_QUERY_RESULT, &nanoseconds);
+		pending[query] = false;
+		gpuSum += float(nanoseconds / 1e6);
+		nGpuFrames++;
+	}
+}
+
+void PerfHud::refresh()
+{
+	frameMs = nFrames > 0 ? frameSum / nFrames : 0.f;
+	updateMs = nRenders > 0 ? updateSum / nRenders : 0.f;
+	renderMs = nRenders > 0 ? renderSum / nRenders : 0.f;
+	gpuValid = nGpuFrames > 0;
+	gpuMs = gpuValid ? gpuSum / nGpuFrames : 0.f;
+	frameSum = updateSum = renderSum = gpuSum = 0.f;
+	nFrames = nRenders = nGpuFrames = 0;
+}
+
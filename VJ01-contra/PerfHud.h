@@ -0,0 +1,82 @@
+#ifndef _PERF_HUD_INCLUDE
+#define _PERF_HUD_INCLUDE
+
+
+#include <chrono>
+#include <string>
+#include <GL/glew.h>
+#include "ShaderProgram.h"
+#include "SpriteBatch.h"
+#include "TextRenderer.h"
+
+
+using namespace std;
+
+
+#define HUD_QUERIES 4
+
+
+// PerfHud is an overlay with the performance of the last frames: frame
+// time, the update and render split, the GPU time of the scene, draw
+// calls, live bullets and enemies and texture memory. Timings are averaged
+// over half a second so they can be read; update and render are per frame.
+//
+// The GPU time comes from timer queries around the scene, kept in a small
+// ring so reading a result never waits for the GPU. The overlay is drawn
+// after the scene has been measured, in a batch of its own that is a
+// single draw call, and its own draw call is left out of the counters.
+// While hidden it measures nothing.
+
+
+class PerfHud
+{
+
+public:
+	PerfHud();
+
+	// Draws with the texture program of the scene
+	void init(ShaderProgram &program);
+	void free();
+
+	void toggle();
+	bool isVisible() const { return visible; }
+
+	// Around the update of every tick
+	void beginUpdate();
+	void endUpdate();
+	// At the start of the frame, before the scene is rendered
+	void beginFrame();
+	// After the scene, with the counters of the scene
+	void render(int bullets, int enemies, int activeEnemies);
+
+private:
+	void collectQueries();
+	void refresh();
+
+private:
+	bool visible;
+	ShaderProgram *program;
+	UniformHandle projectionUniform, colorUniform;
+	SpriteBatch batch;
+	TextRenderer text;
+	int hudVertices;
+
+	// Timer queries, pending while their result has not been read
+	GLuint queries[HUD_QUERIES];
+	bool pending[HUD_QUERIES];
+	int nextQuery;
+	bool timing;
+
+	chrono::steady_clock::time_point frameStart, updateStart;
+	bool firstFrame;
+	// Sums since the last refresh and the averages shown
+	float frameSum, updateSum, renderSum, gpuSum;
+	int nFrames, nRenders, nGpuFrames;
+	float frameMs, updateMs, renderMs, gpuMs;
+	bool gpuValid;
+
+};
+
+
+#endif // _PERF_HUD_INCLUDE
+
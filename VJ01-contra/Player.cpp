@@ -6,7 +6,6 @@
 #include <GL/glut.h>
 #include "Player.h"
 #include "Game.h"
-#include "Bullet.h"
 
 
 #define JUMP_ANGLE_STEP 4
@@ -17,73 +16,45 @@
 #define GUN_POSITION_Y 10
 
 
-enum PlayerAnims
-{
-	STAND_LEFT, STAND_RIGHT, MOVE_LEFT, MOVE_RIGHT
-};
+Player::Player() {
+	entities = NULL;
+	id = -1;
+	projectiles = NULL;
+}
 
-void Player::init(const glm::ivec2& tileMapPos, ShaderProgram& shaderProgram) {
-	this->shaderProgram = &shaderProgram;
+void Player::init(EntityStore& entityStore, const glm::ivec2& pos) {
 	bJumping = false;
 	life = 3;
-	spritesheet.loadFromFile("images/main_character.png", TEXTURE_PIXEL_FORMAT_RGBA);
-	sprite = Sprite::createSprite(getSize(), glm::vec2(1.f / 10.f, 1.f / 10.f), &spritesheet, &shaderProgram);
-	spritesheet.setMinFilter(GL_NEAREST);
-	spritesheet.setMagFilter(GL_NEAREST);
-	sprite->setNumberAnimations(4);
-
-	sprite->setAnimationSpeed(STAND_LEFT, 8);
-	sprite->addKeyframe(STAND_LEFT, glm::vec2(0.f, 0.f));
-
-	sprite->setAnimationSpeed(STAND_RIGHT, 8);
-	sprite->addKeyframe(STAND_RIGHT, glm::vec2(4.f / 10.f, 0.f));
-
-	sprite->setAnimationSpeed(MOVE_LEFT, 8);
-	sprite->addKeyframe(MOVE_LEFT, glm::vec2(0.f / 10.f, 1.f / 10.f));
-	sprite->addKeyframe(MOVE_LEFT, glm::vec2(1.f / 10.f, 1.f / 10.f));
-	sprite->addKeyframe(MOVE_LEFT, glm::vec2(2.f / 10.f, 1.f / 10.f));
-	sprite->addKeyframe(MOVE_LEFT, glm::vec2(3.f / 10.f, 1.f / 10.f));
-	sprite->addKeyframe(MOVE_LEFT, glm::vec2(4.f / 10.f, 1.f / 10.f));
-	sprite->addKeyframe(MOVE_LEFT, glm::vec2(2.f / 10.f, 1.f / 10.f));
-
-	sprite->setAnimationSpeed(MOVE_RIGHT, 8);
-	sprite->addKeyframe(MOVE_RIGHT, glm::vec2(5.f / 10.f, 1.f / 10.f));
-	sprite->addKeyframe(MOVE_RIGHT, glm::vec2(6.f / 10.f, 1.f / 10.f));
-	sprite->addKeyframe(MOVE_RIGHT, glm::vec2(7.f / 10.f, 1.f / 10.f));
-	sprite->addKeyframe(MOVE_RIGHT, glm::vec2(8.f / 10.f, 1.f / 10.f));
-	sprite->addKeyframe(MOVE_RIGHT, glm::vec2(9.f / 10.f, 1.f / 10.f));
-	sprite->addKeyframe(MOVE_RIGHT, glm::vec2(7.f / 10.f, 1.f / 10.f));
-
-	sprite->changeAnimation(STAND_RIGHT);
-	tileMapDispl = tileMapPos;
-	sprite->setPosition(glm::vec2(float(tileMapDispl.x + posPlayer.x), float(tileMapDispl.y + posPlayer.y)));
+	entities = &entityStore;
+	id = entities->create(entities->addType("images/main_character.txt"), pos, TEAM_PLAYER, STAND_RIGHT);
 	spreadgun = false;
 
 }
 
-void Player::update(int deltaTime) {
-	sprite->update(deltaTime);
+void Player::update(float deltaTime) {
+	glm::ivec2 posPlayer = entities->getPosition(id);
+
 	if (Game::instance().getSpecialKey(GLUT_KEY_LEFT)) {
-		if (sprite->getCurrentAnimation() != MOVE_LEFT)
-			sprite->changeAnimation(MOVE_LEFT);
+		if (entities->getAnimation(id) != MOVE_LEFT)
+			entities->changeAnimation(id, MOVE_LEFT);
 		posPlayer.x -= RUN_SPEED;
 		if (map->collisionMoveLeft(posPlayer + getHitbox(1), getHitbox(0))) {
 			posPlayer.x += RUN_SPEED;
-			sprite->changeAnimation(STAND_LEFT);
+			entities->changeAnimation(id, STAND_LEFT);
 		}
 	} else if (Game::instance().getSpecialKey(GLUT_KEY_RIGHT)) {
-		if (sprite->getCurrentAnimation() != MOVE_RIGHT)
-			sprite->changeAnimation(MOVE_RIGHT);
+		if (entities->getAnimation(id) != MOVE_RIGHT)
+			entities->changeAnimation(id, MOVE_RIGHT);
 		posPlayer.x += RUN_SPEED;
 		if (map->collisionMoveRight(posPlayer + getHitbox(1), getHitbox(0))) {
 			posPlayer.x -= RUN_SPEED;
-			sprite->changeAnimation(STAND_RIGHT);
+			entities->changeAnimation(id, STAND_RIGHT);
 		}
 	} else {
-		if (sprite->getCurrentAnimation() == MOVE_LEFT)
-			sprite->changeAnimation(STAND_LEFT);
-		else if (sprite->getCurrentAnimation() == MOVE_RIGHT)
-			sprite->changeAnimation(STAND_RIGHT);
+		if (entities->getAnimation(id) == MOVE_LEFT)
+			entities->changeAnimation(id, STAND_LEFT);
+		else if (entities->getAnimation(id) == MOVE_RIGHT)
+			entities->changeAnimation(id, STAND_RIGHT);
 	}
 
 	if (bJumping) {
@@ -107,143 +78,45 @@ void Player::update(int deltaTime) {
 				posPlayer.y += FALL_STEP - 1;
 				Game::instance().specialKeyReleased(GLUT_KEY_DOWN);
 			} else if (Game::instance().getKey('\r')) {
+				glm::vec2 gunPos = posPlayer + getHitbox(1) + glm::ivec2(GUN_POSITION_X, GUN_POSITION_Y);
+				projectiles->spawn(gunPos, getDirection(), TEAM_PLAYER);
 				if (spreadgun) {
-					bullets.emplace_back(make_shared<Bullet>(posPlayer + getHitbox(1) + glm::ivec2(GUN_POSITION_X, GUN_POSITION_Y), getDirection(), *shaderProgram));
-					bullets.emplace_back(make_shared<Bullet>(posPlayer + getHitbox(1) + glm::ivec2(GUN_POSITION_X, GUN_POSITION_Y), getDirection() + glm::vec2(0, 0.03), *shaderProgram));
-					bullets.emplace_back(make_shared<Bullet>(posPlayer + getHitbox(1) + glm::ivec2(GUN_POSITION_X, GUN_POSITION_Y), getDirection() + glm::vec2(0, 0.06), *shaderProgram));
-					bullets.emplace_back(make_shared<Bullet>(posPlayer + getHitbox(1) + glm::ivec2(GUN_POSITION_X, GUN_POSITION_Y), getDirection() - glm::vec2(0, 0.03), *shaderProgram));
-					bullets.emplace_back(make_shared<Bullet>(posPlayer + getHitbox(1) + glm::ivec2(GUN_POSITION_X, GUN_POSITION_Y), getDirection() - glm::vec2(0, 0.06), *shaderProgram));
-				} else {
-					bullets.emplace_back(make_shared<Bullet>(posPlayer + getHitbox(1) + glm::ivec2(GUN_POSITION_X, GUN_POSITION_Y), getDirection(), *shaderProgram));
+					projectiles->spawn(gunPos, getDirection() + glm::vec2(0, 0.03), TEAM_PLAYER);
+					projectiles->spawn(gunPos, getDirection() + glm::vec2(0, 0.06), TEAM_PLAYER);
+					projectiles->spawn(gunPos, getDirection() - glm::vec2(0, 0.03), TEAM_PLAYER);
+					projectiles->spawn(gunPos, getDirection() - glm::vec2(0, 0.06), TEAM_PLAYER);
 				}
-				Game::instance().getSoundEngine()->play2D("sounds/shoot.wav");
+				Game::instance().getSound().play(SOUND_SHOOT);
 				Game::instance().keyReleased('\r');
 			}
 		}
 	}
 
-	sprite->setPosition(glm::vec2(float(tileMapDispl.x + posPlayer.x), float(tileMapDispl.y + posPlayer.y)));
-	for (auto bullet : bullets) {
-		bullet->update(deltaTime);
-	}
-	bullets.erase(remove_if(bullets.begin(), bullets.end(), [](shared_ptr<Bullet> bullet) {
-		return !bullet->isAlive();
-		}), bullets.end());
-}
-
-void Player::render() {
-	for (auto bullet : bullets) {
-		bullet->render();
-	}
-	sprite->render();
+	entities->setPosition(id, posPlayer);
 }
 
 void Player::setTileMap(TileMap* tileMap) {
 	map = tileMap;
 }
 
-void Player::setPosition(const glm::vec2& pos) {
-	posPlayer = pos;
-	sprite->setPosition(glm::vec2(float(tileMapDispl.x + posPlayer.x), float(tileMapDispl.y + posPlayer.y)));
+void Player::setProjectiles(ProjectileSystem* projectileSystem) {
+	projectiles = projectileSystem;
 }
 
 glm::ivec2 Player::getPosition() const {
-	return posPlayer;
+	return entities->getPosition(id);
 }
 
 glm::ivec2 Player::getSize() const {
-	return glm::ivec2(48, 48);
+	return entities->getSize(id);
 }
 
 glm::ivec2 Player::getHitbox(bool top) const {
-	switch (sprite->getCurrentAnimation()) {
-	case STAND_LEFT:
-		if (top) return glm::ivec2(20, 13);
-		else return glm::ivec2(14, 47);
-		break;
-	case STAND_RIGHT:
-		if (top) return glm::ivec2(18, 13);
-		else return glm::ivec2(13, 47);
-		break;
-	case MOVE_LEFT:
-		switch (sprite->getCurrentKeyframe()) {
-		case 0:
-			if (top) return glm::ivec2(18, 13);
-			else return glm::ivec2(15, 47);
-			break;
-		case 1:
-			if (top) return glm::ivec2(18, 13);
-			else return glm::ivec2(17, 47);
-			break;
-		case 2:
-			if (top) return glm::ivec2(16, 16);
-			else return glm::ivec2(20, 47);
-			break;
-		case 3:
-			if (top) return glm::ivec2(16, 13);
-			else return glm::ivec2(17, 47);
-			break;
-		case 4:
-			if (top) return glm::ivec2(16, 13);
-			else return glm::ivec2(17, 47);
-			break;
-		case 5:
-			if (top) return glm::ivec2(16, 16);
-			else return glm::ivec2(20, 47);
-			break;
-		default:
-			if (top) return glm::ivec2(0, 0);
-			else return glm::ivec2(48, 48);
-			break;
-		}
-		break;
-	case MOVE_RIGHT:
-		switch (sprite->getCurrentKeyframe()) {
-		case 0:
-			if (top) return glm::ivec2(19, 13);
-			else return glm::ivec2(14, 47);
-			break;
-		case 1:
-			if (top) return glm::ivec2(17, 13);
-			else return glm::ivec2(15, 47);
-			break;
-		case 2:
-			if (top) return glm::ivec2(16, 16);
-			else return glm::ivec2(20, 47);
-			break;
-		case 3:
-			if (top) return glm::ivec2(19, 14);
-			else return glm::ivec2(15, 47);
-			break;
-		case 4:
-			if (top) return glm::ivec2(17, 14);
-			else return glm::ivec2(17, 47);
-			break;
-		case 5:
-			if (top) return glm::ivec2(16, 16);
-			else return glm::ivec2(20, 47);
-			break;
-		default:
-			if (top) return glm::ivec2(0, 0);
-			else return glm::ivec2(48, 48);
-			break;
-		}
-		break;
-	default:
-		if (top) return glm::ivec2(0, 0);
-		else return glm::ivec2(48, 48);
-	}
+	return entities->getHitbox(id, top);
 }
 
 glm::vec2 Player::getDirection() const {
-	switch (sprite->getCurrentAnimation()) {
-	case STAND_LEFT:
-	case MOVE_LEFT:
-		return glm::vec2(-1.0f, 0.0f);
-	case STAND_RIGHT:
-	case MOVE_RIGHT:
-		return glm::vec2(1.0f, 0.0f);
-	}
+	return entities->getDirection(id);
 }
 
 int Player::getLife() const {
@@ -259,10 +132,6 @@ void Player::decreaseLife() {
 	spreadgun = false;
 }
 
-vector<shared_ptr<Bullet>> Player::getBullets() const {
-	return bullets;
-}
-
 void Player::setSpreadgun(bool b) {
 	spreadgun = b;
 }
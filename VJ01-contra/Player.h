@@ -1,26 +1,26 @@
 #ifndef _PLAYER_INCLUDE
 #define _PLAYER_INCLUDE
 
-#include <memory>
-#include "Sprite.h"
+#include "EntityStore.h"
 #include "TileMap.h"
-#include "Bullet.h"
+#include "ProjectileSystem.h"
 
 
-// Player is basically a Sprite that represents the player. As such it has
-// all properties it needs to track its movement, jumping, and collisions.
+// Player controls the player's entity of the EntityStore. It keeps what
+// only the player has: jumping, lives and the spread gun.
 
 
 class Player
 {
 
 public:
-	void init(const glm::ivec2 &tileMapPos, ShaderProgram &shaderProgram);
-	void update(int deltaTime);
-	void render();
+	Player();
+
+	void init(EntityStore &entityStore, const glm::ivec2 &pos);
+	void update(float deltaTime);
 	
 	void setTileMap(TileMap *tileMap);
-	void setPosition(const glm::vec2 &pos);
+	void setProjectiles(ProjectileSystem *projectileSystem);
 	glm::ivec2 getPosition() const;
 	glm::ivec2 getSize() const;
 	glm::ivec2 getHitbox(bool top) const;
@@ -28,19 +28,16 @@ public:
 	int getLife() const;
 	bool getSpreadgun() const;
 	void decreaseLife();
-	vector<shared_ptr<Bullet>> getBullets() const;
 	void setSpreadgun(bool b);
 	
 private:
 	bool bJumping;
 	int life;
-	glm::ivec2 tileMapDispl, posPlayer;
 	int jumpAngle, startY;
-	Texture spritesheet;
-	Sprite *sprite;
+	EntityStore *entities;
+	int id;
 	TileMap *map;
-	ShaderProgram* shaderProgram;
-	vector<shared_ptr<Bullet>> bullets;
+	ProjectileSystem *projectiles;
 	bool spreadgun;
 
 };
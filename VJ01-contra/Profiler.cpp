@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include "Profiler.h"
+
+
+Profiler::Profiler()
+{
+	origin = chrono::steady_clock::now();
+	nEvents = 0;
+	frame = 0;
+	for(int zone=0; zone<PROFILER_MAX_ZONES; zone++)
+	{
+		frameTimes[zone] = 0;
+		frameCalls[zone] = 0;
+	}
+}
+
+
+int Profiler::registerZone(const char *name)
+{
+	for(unsigned int zone=0; zone<zoneNames.size(); zone++)
+	{
+		if(strcmp(zoneNames[zone], name) == 0)
+			return int(zone);
+	}
+	// Zones beyond the limit are all accounted to the last one
+	if(zoneNames.size() == PROFILER_MAX_ZONES)
+		return PROFILER_MAX_ZONES - 1;
+	zoneNames.push_back(name);
+
+	return int(zoneNames.size()) - 1;
+}
+
+void Profiler::addEvent(int zone, long long start, long long end)
+{
+	ProfileEvent event;
+
+	event.zone = zone;
+	event.frame = frame;
+	event.start = start;
+	event.end = end;
+	if(events.size() < PROFILER_MAX_EVENTS)
+		events.push_back(event);
+	else
+		events[nEvents % PROFILER_MAX_EVENTS] = event;
+	nEvents++;
+	frameTimes[zone] += end - start;
+	frameCalls[zone]++;
+}
+
+void Profiler::endFrame()
+{
+	unsigned int slot = (unsigned int)(frame % PROFILER_MAX_FRAMES) * PROFILER_MAX_ZONES;
+
+	if(frameSamples.size() < PROFILER_MAX_FRAMES * PROFILER_MAX_ZONES)
+		frameSamples.resize(frameSamples.size() + PROFILER_MAX_ZONES);
+	for(int zone=0; zone<PROFILER_MAX_ZONES; zone++)
+	{
+		frameSamples[slot + zone] = frameCalls[zone] > 0 ? frameTimes[zone] / 1e3f : -1.f;
+		frameTimes[zone] = 0;
+		frameCalls[zone] = 0;
+	}
+	frame++;
+}
+
+float Profiler::getFrameTime(int zone) const
+{
+	if(frame == 0)
+		return 0.f;
+	return max(0.f, frameSamples[((frame - 1) % PROFILER_MAX_FRAMES) * PROFILER_MAX_ZONES + zone]);
+}
+
+long long Profiler::now() const
+{
+	return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin).count();
+}
+
+bool Profiler::writeChromeTrace(const string &filename) const
+{
+	ofstream fout(filename.c_str());
+	size_t first = nEvents > PROFILER_MAX_EVENTS ? size_t(nEvents % PROFILER_MAX_EVENTS) : 0;
+
+	if(!fout.is_open())
+		return false;
+	// Complete ("X") events, with timestamps and durations in microseconds
+	fout << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << endl;
+	fout << fixed << setprecision(3);
+	for(size_t i=0; i<events.size(); i++)
+	{
+		const ProfileEvent &event = events[(first + i) % events.size()];
+
+		fout << (i > 0 ? ",\n" : "") << "{\"name\":\"" << zoneNames[event.zone] << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+			<< ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0
+			<< ",\"args\":{\"frame\":" << event.frame << "}}";
+	}
+	fout << endl << "]}" << endl;
+
+	return !fout.fail();
+}
+
+void Profiler::printSummary(ostream &out) const
+{
+	int nFrames = int(frameSamples.size() / PROFILER_MAX_ZONES);
+	vector<float> samples;
+
+	out << "Profile of the last " << nFrames << " frames (us per frame)" << endl;
+	out << left << setw(24) << "zone" << right << setw(8) << "frames" << setw(10) << "p50" << setw(10) << "p90" << setw(10) << "p99" << setw(10) << "max" << endl;
+	out << fixed << setprecision(1);
+	for(unsigned int zone=0; zone<zoneNames.size(); zone++)
+	{
+		samples.clear();
+		for(int f=0; f<nFrames; f++)
+		{
+			if(frameSamples[f * PROFILER_MAX_ZONES + zone] >= 0.f)
+				samples.push_back(frameSamples[f * PROFILER_MAX_ZONES + zone]);
+		}
+		if(samples.empty())
+			continue;
+		sort(samples.begin(), samples.end());
+		out << left << setw(24) << zoneNames[zone] << right << setw(8) << samples.size()
+			<< setw(10) << samples[(samples.size() - 1) * 50 / 100]
+			<< setw(10) << samples[(samples.size() - 1) * 90 / 100]
+			<< setw(10) << samples[(samples.size() - 1) * 99 / 100]
+			<< setw(10) << samples.back() << endl;
+	}
+	out.unsetf(ios::fixed);
+}
+
@@ -0,0 +1,117 @@
+#ifndef _PROFILER_INCLUDE
+#define _PROFILER_INCLUDE
+
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+using namespace std;
+
+
+// Profiler is a singleton that times named zones of code. Zones are marked
+// with PROFILE_ZONE("name"), which times the rest of the enclosing scope,
+// and frames are delimited with PROFILE_FRAME(). Every zone execution is
+// kept in a ring buffer of events, exported as a Chrome trace (open it in
+// chrome://tracing or ui.perfetto.dev), and every frame adds up the time of
+// each zone in a ring buffer of frame samples, summarized as percentiles.
+//
+// The macros expand to nothing unless ENABLE_PROFILER is defined (it is in
+// Debug builds), so release code pays nothing for them.
+
+
+#define PROFILER_MAX_ZONES 32
+#define PROFILER_MAX_EVENTS 65536
+#define PROFILER_MAX_FRAMES 1024
+
+
+struct ProfileEvent
+{
+	int zone;
+	int frame;
+	long long start, end; // Nanoseconds since the profiler was created
+};
+
+
+class Profiler
+{
+
+public:
+	Profiler();
+
+	static Profiler &instance()
+	{
+		static Profiler P;
+
+		return P;
+	}
+
+	// Returns the id of the zone with this name, registering it if needed
+	int registerZone(const char *name);
+	void addEvent(int zone, long long start, long long end);
+	void endFrame();
+
+	long long now() const;
+	int getFrame() const { return frame; }
+	// Microseconds spent in the zone in the last frame ended, 0 if it did not run
+	float getFrameTime(int zone) const;
+
+	bool writeChromeTrace(const string &filename) const;
+	// Microseconds spent per frame in each zone: 50th, 90th and 99th percentile
+	// and maximum, over the frames in which the zone ran
+	void printSummary(ostream &out) const;
+
+private:
+	chrono::steady_clock::time_point origin;
+	vector<const char *> zoneNames;
+	vector<ProfileEvent> events;    // Ring buffer, the oldest event is events[nEvents % PROFILER_MAX_EVENTS] once full
+	long long nEvents;
+	vector<float> frameSamples;     // Ring buffer of PROFILER_MAX_ZONES times per frame, in microseconds (-1 = zone not run)
+	long long frameTimes[PROFILER_MAX_ZONES];
+	int frameCalls[PROFILER_MAX_ZONES];
+	int frame;
+
+};
+
+
+// Times the scope it is created in
+class ProfileScope
+{
+
+public:
+	ProfileScope(int zone)
+	{
+		this->zone = zone;
+		start = Profiler::instance().now();
+	}
+
+	~ProfileScope()
+	{
+		Profiler::instance().addEvent(zone, start, Profiler::instance().now());
+	}
+
+private:
+	int zone;
+	long long start;
+
+};
+
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_ZONE(name) \
+	static const int PROFILE_CONCAT(profileZone, __LINE__) = Profiler::instance().registerZone(name); \
+	ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(PROFILE_CONCAT(profileZone, __LINE__))
+#define PROFILE_FRAME() Profiler::instance().endFrame()
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_FRAME()
+#endif
+
+
+#endif // _PROFILER_INCLUDE
+
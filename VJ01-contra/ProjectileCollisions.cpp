@@ -0,0 +1,63 @@
+#include "ProjectileCollisions.h"
+#include "JobSystem.h"
+
+
+#define MAX_BULLET_HITS 16
+#define COLLISION_GRAIN 256
+
+
+void ProjectileCollisions::init(float windowWidth)
+{
+	enemyGrid.init(windowWidth);
+	nEnemyHits = 0;
+}
+
+void ProjectileCollisions::find(const EntityStore &entities, const vector<int> &active, const ProjectileSystem &projectiles, const glm::vec2 &playerMin, const glm::vec2 &playerMax, float windowLeft)
+{
+	enemyGrid.clear(windowLeft);
+	for(unsigned int a=0; a<active.size(); a++)
+	{
+		int e = active[a];
+		glm::vec2 posE = entities.getPosition(e) + entities.getHitbox(e, true);
+		glm::vec2 sizeE = entities.getHitbox(e, false);
+		enemyGrid.insert(a, posE, glm::vec2(posE.x + sizeE.x, entities.getPosition(e).y + sizeE.y));
+	}
+	enemyGrid.build();
+	enemyHit.assign(active.size(), 0);
+
+	int nBullets = projectiles.getUsed();
+	int nRanges = JobSystem::getNumRanges(nBullets, COLLISION_GRAIN);
+	if(int(rangeHits.size()) < nRanges)
+		rangeHits.resize(nRanges);
+	playerHit.assign(nBullets, 0);
+	JobSystem::instance().parallelFor(nBullets, COLLISION_GRAIN, [&](int begin, int end) {
+		const float *bulletsX = projectiles.getPositionsX();
+		const float *bulletsY = projectiles.getPositionsY();
+		vector<int> &candidates = rangeHits[begin / COLLISION_GRAIN];
+		int hits[MAX_BULLET_HITS];
+
+		candidates.clear();
+		for(int i=begin; i<end; i++)
+		{
+			if(!projectiles.isAlive(i))
+				continue;
+			if(projectiles.getTeam(i) == TEAM_ENEMY)
+			{
+				playerHit[i] = bulletsX[i] > playerMin.x && bulletsX[i] < playerMax.x &&
+					bulletsY[i] > playerMin.y && bulletsY[i] < playerMax.y;
+				continue;
+			}
+			int nHits = enemyGrid.queryPoint(glm::vec2(bulletsX[i], bulletsY[i]), hits, MAX_BULLET_HITS);
+			candidates.insert(candidates.end(), hits, hits + nHits);
+		}
+	});
+
+	nEnemyHits = 0;
+	for(int r=0; r<nRanges; r++)
+	{
+		for(unsigned int h=0; h<rangeHits[r].size(); h++)
+			enemyHit[rangeHits[r][h]] = 1;
+		nEnemyHits += int(rangeHits[r].size());
+	}
+}
+
@@ -0,0 +1,54 @@
+#ifndef _PROJECTILE_COLLISIONS_INCLUDE
+#define _PROJECTILE_COLLISIONS_INCLUDE
+
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "EntityStore.h"
+#include "ProjectileSystem.h"
+#include "CollisionGrid.h"
+
+
+using namespace std;
+
+
+// ProjectileCollisions finds the bullets that hit the player and the
+// enemies of one tick. Player bullets are only tested against the active
+// enemies, bucketed in a CollisionGrid; enemy bullets against the player box.
+//
+// Candidate hits are found in parallel, one list per range of bullets, so
+// find() only reads the scene. Applying the hits (killing bullets and
+// enemies, sounds) is left to the caller, in bullet order.
+
+
+class ProjectileCollisions
+{
+
+public:
+	// Width of the window around the camera where enemies are active
+	void init(float windowWidth);
+
+	// Boxes of the player and the enemies go from their hitbox offset to
+	// their position plus the hitbox size. The grid is laid over the window
+	// starting at windowLeft.
+	void find(const EntityStore &entities, const vector<int> &active, const ProjectileSystem &projectiles, const glm::vec2 &playerMin, const glm::vec2 &playerMax, float windowLeft);
+
+	// Indexed by bullet slot, up to the projectiles' getUsed() at find()
+	bool isPlayerHit(int bullet) const { return playerHit[bullet] != 0; }
+	// Indexed like the active enemies
+	bool isEnemyHit(int index) const { return enemyHit[index] != 0; }
+	// Every bullet that hit an enemy, counted once per enemy it hit
+	int getNumEnemyHits() const { return nEnemyHits; }
+
+private:
+	CollisionGrid enemyGrid;
+	vector<unsigned char> enemyHit;
+	vector<unsigned char> playerHit;
+	vector<vector<int>> rangeHits;         // Enemies hit by each range of bullets
+	int nEnemyHits;
+
+};
+
+
+#endif // _PROJECTILE_COLLISIONS_INCLUDE
+
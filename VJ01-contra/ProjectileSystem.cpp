@@ -0,0 +1,124 @@
+#include "ProjectileSystem.h"
+#include "TextureManager.h"
+#include "JobSystem.h"
+
+
+#define MAX_DISTANCE 100
+#define SPEED 2
+#define BULLET_SIZE 5
+#define UPDATE_GRAIN 256
+
+
+ProjectileSystem::ProjectileSystem()
+{
+	spritesheet = NULL;
+	clear();
+}
+
+ProjectileSystem::~ProjectileSystem()
+{
+	TextureManager::instance().release(spritesheet);
+}
+
+
+void ProjectileSystem::init()
+{
+	clear();
+	if(spritesheet != NULL)
+		return;
+	spritesheet = TextureManager::instance().acquireRegion("images/bullet.png", TEXTURE_PIXEL_FORMAT_RGBA, region);
+	spritesheet->setMinFilter(GL_NEAREST);
+	spritesheet->setMagFilter(GL_NEAREST);
+}
+
+void ProjectileSystem::update(float deltaTime)
+{
+	// Range is measured in steps along the (not normalized) direction,
+	// so every bullet lives for MAX_DISTANCE / SPEED updates.
+	// Bullets move in parallel, expired ones are killed afterwards in slot order.
+	JobSystem::instance().parallelFor(used, UPDATE_GRAIN, [this](int begin, int end) {
+		for(int i=begin; i<end; i++)
+		{
+			if(!alive[i])
+				continue;
+			prevX[i] = posX[i];
+			prevY[i] = posY[i];
+			posX[i] += dirX[i] * SPEED;
+			posY[i] += dirY[i] * SPEED;
+			range[i] -= SPEED;
+		}
+	});
+	for(int i=0; i<used; i++)
+	{
+		if(alive[i] && range[i] <= 0.f)
+			kill(i);
+	}
+}
+
+void ProjectileSystem::render(SpriteBatch &batch)
+{
+	glm::vec2 size(BULLET_SIZE, BULLET_SIZE);
+	float alpha = batch.getInterpolation();
+
+	for(int i=0; i<used; i++)
+	{
+		if(!alive[i])
+			continue;
+		batch.draw(spritesheet, glm::vec2(prevX[i] + alpha * (posX[i] - prevX[i]), prevY[i] + alpha * (posY[i] - prevY[i])), size, region.uvOffset, region.uvOffset + region.uvScale);
+	}
+}
+
+void ProjectileSystem::clear()
+{
+	firstFree = -1;
+	used = 0;
+	liveCount = 0;
+}
+
+int ProjectileSystem::spawn(const glm::vec2 &pos, const glm::vec2 &dir, ProjectileTeam team)
+{
+	int id;
+
+	if(firstFree != -1)
+	{
+		id = firstFree;
+		firstFree = nextFree[id];
+	}
+	else if(used < MAX_PROJECTILES)
+		id = used++;
+	else
+		return -1;
+
+	posX[id] = prevX[id] = pos.x;
+	posY[id] = prevY[id] = pos.y;
+	dirX[id] = dir.x;
+	dirY[id] = dir.y;
+	range[id] = float(MAX_DISTANCE);
+	this->team[id] = (unsigned char)team;
+	alive[id] = 1;
+	liveCount++;
+
+	return id;
+}
+
+void ProjectileSystem::kill(int id)
+{
+	if(!alive[id])
+		return;
+	alive[id] = 0;
+	nextFree[id] = firstFree;
+	firstFree = id;
+	liveCount--;
+}
+
+void ProjectileSystem::fill(int count, const glm::ivec2 &minPos, const glm::ivec2 &maxPos, Random &random)
+{
+	for(int i=liveCount; i<count; i++)
+	{
+		glm::vec2 pos(float(random.range(minPos.x, maxPos.x)), float(random.range(minPos.y, maxPos.y)));
+		glm::vec2 dir(random.range(0, 1) == 0 ? -1.f : 1.f, 0.f);
+		if(spawn(pos, dir, i % 2 == 0 ? TEAM_PLAYER : TEAM_ENEMY) == -1)
+			break;
+	}
+}
+
@@ -0,0 +1,67 @@
+#ifndef _PROJECTILE_SYSTEM_INCLUDE
+#define _PROJECTILE_SYSTEM_INCLUDE
+
+
+#include <glm/glm.hpp>
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "Random.h"
+
+
+#define MAX_PROJECTILES 4096
+
+
+enum ProjectileTeam { TEAM_PLAYER, TEAM_ENEMY };
+
+
+// ProjectileSystem stores every bullet of the scene in fixed size arrays
+// (one array per attribute). Free slots are chained in a free list so
+// spawning and killing a bullet are O(1) and never allocate memory.
+// Slots in [0, getUsed()) may be iterated directly by collision code,
+// skipping those that are not alive.
+
+
+class ProjectileSystem
+{
+
+public:
+	ProjectileSystem();
+	~ProjectileSystem();
+
+	void init();
+	void update(float deltaTime);
+	void render(SpriteBatch &batch);
+	void clear();
+
+	// Returns the slot of the new bullet or -1 if the system is full
+	int spawn(const glm::vec2 &pos, const glm::vec2 &dir, ProjectileTeam team);
+	void kill(int id);
+	// Tops the live bullets up to count, flying left or right from random
+	// places in [minPos, maxPos]. Half of them are the player's.
+	void fill(int count, const glm::ivec2 &minPos, const glm::ivec2 &maxPos, Random &random);
+
+	int getUsed() const { return used; }
+	int getLiveCount() const { return liveCount; }
+	bool isAlive(int id) const { return alive[id] != 0; }
+	ProjectileTeam getTeam(int id) const { return ProjectileTeam(team[id]); }
+	glm::vec2 getPosition(int id) const { return glm::vec2(posX[id], posY[id]); }
+	const float *getPositionsX() const { return posX; }
+	const float *getPositionsY() const { return posY; }
+
+private:
+	float posX[MAX_PROJECTILES], posY[MAX_PROJECTILES];
+	float prevX[MAX_PROJECTILES], prevY[MAX_PROJECTILES];
+	float dirX[MAX_PROJECTILES], dirY[MAX_PROJECTILES];
+	float range[MAX_PROJECTILES];
+	unsigned char team[MAX_PROJECTILES];
+	unsigned char alive[MAX_PROJECTILES];
+	int nextFree[MAX_PROJECTILES];
+	int firstFree, used, liveCount;
+	Texture *spritesheet;
+	AtlasRegion region;
+
+};
+
+
+#endif // _PROJECTILE_SYSTEM_INCLUDE
+
@@ -0,0 +1,25 @@
+#include "Random.h"
+
+
+Random::Random(unsigned int seed)
+{
+	setSeed(seed);
+}
+
+
+void Random::setSeed(unsigned int seed)
+{
+	this->seed = seed;
+	engine.seed(seed);
+}
+
+unsigned int Random::next()
+{
+	return (unsigned int)engine();
+}
+
+int Random::range(int min, int max)
+{
+	return min + int(next() % (unsigned int)(max - min + 1));
+}
+
@@ -0,0 +1,41 @@
+#ifndef _RANDOM_INCLUDE
+#define _RANDOM_INCLUDE
+
+
+#include <random>
+
+
+using namespace std;
+
+
+#define DEFAULT_SEED 1
+
+
+// Random is a seedable random number generator. Values are taken from the
+// raw output of mt19937, whose sequence is fixed by the standard, and not
+// from the library distributions, which differ between compilers. That way
+// the same seed gives the same game on every build.
+
+
+class Random
+{
+
+public:
+	Random(unsigned int seed = DEFAULT_SEED);
+
+	void setSeed(unsigned int seed);
+	unsigned int getSeed() const { return seed; }
+
+	unsigned int next();
+	// Integer in [min, max]
+	int range(int min, int max);
+
+private:
+	mt19937 engine;
+	unsigned int seed;
+
+};
+
+
+#endif // _RANDOM_INCLUDE
+
@@ -0,0 +1,134 @@
+#include "RenderState.h"
+#include "RenderStats.h"
+
+
+// Objects in OpenGL are never 0 once created, so an invalid value is needed
+// to state that the binding is unknown and the next bind must be issued
+#define UNKNOWN_BINDING GLuint(-1)
+
+
+bool RenderState::SamplerKey::operator<(const SamplerKey &key) const
+{
+	if(wrapS != key.wrapS)
+		return wrapS < key.wrapS;
+	if(wrapT != key.wrapT)
+		return wrapT < key.wrapT;
+	if(minFilter != key.minFilter)
+		return minFilter < key.minFilter;
+	return magFilter < key.magFilter;
+}
+
+
+RenderState::RenderState()
+{
+	invalidate();
+}
+
+
+void RenderState::useProgram(GLuint program)
+{
+	countChange(program != currentProgram);
+	if(program != currentProgram)
+	{
+		glUseProgram(program);
+		currentProgram = program;
+	}
+}
+
+void RenderState::bindVertexArray(GLuint vao)
+{
+	countChange(vao != currentVao);
+	if(vao != currentVao)
+	{
+		glBindVertexArray(vao);
+		currentVao = vao;
+	}
+}
+
+void RenderState::bindTexture(int unit, GLuint texture)
+{
+	countChange(texture != currentTextures[unit]);
+	if(texture != currentTextures[unit])
+	{
+		setActiveUnit(unit);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		currentTextures[unit] = texture;
+	}
+}
+
+void RenderState::bindSampler(int unit, GLuint sampler)
+{
+	countChange(sampler != currentSamplers[unit]);
+	if(sampler != currentSamplers[unit])
+	{
+		glBindSampler(unit, sampler);
+		currentSamplers[unit] = sampler;
+	}
+}
+
+GLuint RenderState::getSampler(GLint wrapS, GLint wrapT, GLint minFilter, GLint magFilter)
+{
+	SamplerKey key = {wrapS, wrapT, minFilter, magFilter};
+	map<SamplerKey, GLuint>::iterator it = samplers.find(key);
+	GLuint sampler;
+
+	if(it != samplers.end())
+		return it->second;
+	glGenSamplers(1, &sampler);
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, wrapS);
+	glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, wrapT);
+	glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, minFilter);
+	glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, magFilter);
+	samplers[key] = sampler;
+
+	return sampler;
+}
+
+void RenderState::forgetTexture(GLuint texture)
+{
+	for(int i=0; i<MAX_TEXTURE_UNITS; i++)
+		if(currentTextures[i] == texture)
+			currentTextures[i] = UNKNOWN_BINDING;
+}
+
+void RenderState::forgetVertexArray(GLuint vao)
+{
+	if(currentVao == vao)
+		currentVao = UNKNOWN_BINDING;
+}
+
+void RenderState::forgetProgram(GLuint program)
+{
+	if(currentProgram == program)
+		currentProgram = UNKNOWN_BINDING;
+}
+
+void RenderState::invalidate()
+{
+	currentProgram = UNKNOWN_BINDING;
+	currentVao = UNKNOWN_BINDING;
+	for(int i=0; i<MAX_TEXTURE_UNITS; i++)
+	{
+		currentTextures[i] = UNKNOWN_BINDING;
+		currentSamplers[i] = UNKNOWN_BINDING;
+	}
+	activeUnit = -1;
+}
+
+void RenderState::setActiveUnit(int unit)
+{
+	if(unit != activeUnit)
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		activeUnit = unit;
+	}
+}
+
+void RenderState::countChange(bool issued)
+{
+	if(issued)
+		RenderStats::instance().addStateChange();
+	else
+		RenderStats::instance().addSkippedStateChange();
+}
+
@@ -0,0 +1,70 @@
+#ifndef _RENDER_STATE_INCLUDE
+#define _RENDER_STATE_INCLUDE
+
+
+#include <map>
+#include <GL/glew.h>
+
+
+using namespace std;
+
+
+#define MAX_TEXTURE_UNITS 8
+
+
+// RenderState is a singleton that shadows the OpenGL binding state
+// (program, vertex array, texture and sampler of each unit). Binding an
+// object that is already bound is skipped without calling the driver.
+// Every OpenGL bind of the game must go through it for the cache to hold.
+
+
+class RenderState
+{
+
+public:
+	RenderState();
+
+	static RenderState &instance()
+	{
+		static RenderState RS;
+
+		return RS;
+	}
+
+	void useProgram(GLuint program);
+	void bindVertexArray(GLuint vao);
+	void bindTexture(int unit, GLuint texture);
+	void bindSampler(int unit, GLuint sampler);
+
+	// Sampler objects are shared by all textures with the same parameters
+	GLuint getSampler(GLint wrapS, GLint wrapT, GLint minFilter, GLint magFilter);
+
+	// Deleted objects must be forgotten, OpenGL unbinds them implicitly
+	void forgetTexture(GLuint texture);
+	void forgetVertexArray(GLuint vao);
+	void forgetProgram(GLuint program);
+	void invalidate();
+
+private:
+	void setActiveUnit(int unit);
+	void countChange(bool issued);
+
+private:
+	struct SamplerKey
+	{
+		GLint wrapS, wrapT, minFilter, magFilter;
+
+		bool operator<(const SamplerKey &key) const;
+	};
+
+private:
+	GLuint currentProgram, currentVao;
+	GLuint currentTextures[MAX_TEXTURE_UNITS], currentSamplers[MAX_TEXTURE_UNITS];
+	int activeUnit;
+	map<SamplerKey, GLuint> samplers;
+
+};
+
+
+#endif // _RENDER_STATE_INCLUDE
+
@@ -0,0 +1,28 @@
+#include "RenderStats.h"
+
+
+RenderStats::RenderStats()
+{
+	drawCalls = vertices = stateChanges = skippedStateChanges = 0;
+	lastDrawCalls = lastVertices = lastStateChanges = lastSkippedStateChanges = 0;
+}
+
+
+void RenderStats::beginFrame()
+{
+	lastDrawCalls = drawCalls;
+	lastVertices = vertices;
+	lastStateChanges = stateChanges;
+	lastSkippedStateChanges = skippedStateChanges;
+	drawCalls = 0;
+	vertices = 0;
+	stateChanges = 0;
+	skippedStateChanges = 0;
+}
+
+void RenderStats::addDrawCall(int nVertices)
+{
+	drawCalls++;
+	vertices += nVertices;
+}
+
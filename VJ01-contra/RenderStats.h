@@ -0,0 +1,41 @@
+#ifndef _RENDER_STATS_INCLUDE
+#define _RENDER_STATS_INCLUDE
+
+
+// RenderStats is a singleton that counts what the renderer sends to OpenGL.
+// Counters accumulate during a frame and are published when the next
+// frame begins, so the getters always return the last complete frame.
+
+
+class RenderStats
+{
+
+public:
+	RenderStats();
+
+	static RenderStats &instance()
+	{
+		static RenderStats RS;
+
+		return RS;
+	}
+
+	void beginFrame();
+	void addDrawCall(int nVertices);
+	void addStateChange() { stateChanges++; }
+	void addSkippedStateChange() { skippedStateChanges++; }
+
+	int getDrawCalls() const { return lastDrawCalls; }
+	int getVertices() const { return lastVertices; }
+	int getStateChanges() const { return lastStateChanges; }
+	int getSkippedStateChanges() const { return lastSkippedStateChanges; }
+
+private:
+	int drawCalls, vertices, stateChanges, skippedStateChanges;
+	int lastDrawCalls, lastVertices, lastStateChanges, lastSkippedStateChanges;
+
+};
+
+
+#endif // _RENDER_STATS_INCLUDE
+
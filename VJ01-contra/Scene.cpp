@@ -1,10 +1,15 @@
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <functional>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Scene.h"
 #include "Game.h"
 #include "Player.h"
+#include "TextureManager.h"
+#include "RenderStats.h"
+#include "LevelFile.h"
+#include "Profiler.h"
 
 
 #define SCREEN_X 0
@@ -24,11 +29,44 @@
 #define SPREADGUN_POS_X 200
 #define SPREADGUN_POS_Y 50
 
+#define ENEMY_HALF_HEIGHT 24
+// Enemies this far out of the camera still shoot, their bullets can reach the screen
+#define ACTIVATION_MARGIN 128
+
+#define LEVEL1_FILE "levels/level01.lvl"
+
+
+enum SpawnState { SPAWN_PENDING, SPAWN_ALIVE, SPAWN_KILLED };
+
+
+LevelSettings::LevelSettings()
+{
+	levelFile = LEVEL1_FILE;
+	fireRate = 1.f;
+	projectiles = 0;
+	invulnerable = false;
+}
+
+
+static bool compareSpawnX(const glm::vec2 &p1, const glm::vec2 &p2)
+{
+	return p1.x < p2.x;
+}
+
+
 Scene::Scene()
 {
-	level = START;
+	level = nextLevel = START;
+	loading = false;
 	map = NULL;
 	player = NULL;
+	texture = NULL;
+	textureLife = NULL;
+	textureSpreadgun = NULL;
+	sprite = NULL;
+	spriteLife = NULL;
+	spriteSpreadgun = NULL;
+	cameraX = previousCameraX = 0.0f;
 }
 
 Scene::~Scene()
@@ -37,23 +75,21 @@ Scene::~Scene()
 		delete map;
 	if(player != NULL)
 		delete player;
+	TextureManager::instance().release(texture);
+	TextureManager::instance().release(textureLife);
+	TextureManager::instance().release(textureSpreadgun);
 }
 
 
 void Scene::init()
 {
 	initShaders();
-
-	irrklang::ISoundEngine* soundEngine = Game::instance().getSoundEngine();
+	batch.init(texProgram);
 
 	switch (level) {
 	case START:
 		loadStaticImg("images/startscreen.png");
-		if (backgroundMusic != nullptr) {
-			backgroundMusic->stop();
-			backgroundMusic->drop();
-		}
-		backgroundMusic = soundEngine->play2D("sounds/intro.ogg", true, false, true);
+		Game::instance().getSound().playMusic(MUSIC_INTRO, true);
 		break;
 	case HELP:
 		loadStaticImg("images/helpscreen.png");
@@ -63,48 +99,62 @@ void Scene::init()
 		break;
 	case GAMEOVER:
 		loadStaticImg("images/gameoverscreen.png");
-		if (backgroundMusic != nullptr) {
-			backgroundMusic->stop();
-			backgroundMusic->drop();
-		}
-		backgroundMusic = soundEngine->play2D("sounds/gameover.ogg", false, false, true);
+		Game::instance().getSound().playMusic(MUSIC_GAMEOVER, false);
 		break;
 	case LEVEL1:
-		map = TileMap::createTileMap("levels/level01.txt", glm::vec2(SCREEN_X, SCREEN_Y), texProgram);
+		// Restarting the level must not keep the previous one alive
+		if (map != NULL) {
+			map->free();
+			delete map;
+		}
+		if (player != NULL)
+			delete player;
+		// Every play of the level draws the same numbers for a given seed
+		random.setSeed(Game::instance().getSeed());
+		map = TileMap::createTileMap(settings.levelFile, glm::vec2(SCREEN_X, SCREEN_Y), texProgram);
+		entities.init(glm::ivec2(SCREEN_X, SCREEN_Y));
 		player = new Player();
-		player->init(glm::ivec2(SCREEN_X, SCREEN_Y), texProgram);
-		player->setPosition(glm::vec2(INIT_PLAYER_X_TILES * map->getTileSize(), INIT_PLAYER_Y_TILES * map->getTileSize()));
+		player->init(entities, glm::ivec2(INIT_PLAYER_X_TILES * map->getTileSize(), INIT_PLAYER_Y_TILES * map->getTileSize()));
 		player->setTileMap(map);
-
-		vector<glm::vec2> enemiesPos = {glm::vec2(5, 1), glm::vec2(8, 3), glm::vec2(15, 1), glm::vec2(20, 4),
-			glm::vec2(27, 1), glm::vec2(39, 1), glm::vec2(45, 4), glm::vec2(52, 0),
-			glm::vec2(54, 2), glm::vec2(60, 3), glm::vec2(64, 1), glm::vec2(76, 3),
-			glm::vec2(84, 2), glm::vec2(94, 1), glm::vec2(96, 1), glm::vec2(99, 3)};
-		for (auto pos : enemiesPos) {
-			enemies.emplace_back(make_shared<Enemy>());
-			enemies[enemies.size() - 1]->init(glm::ivec2(SCREEN_X, SCREEN_Y), texProgram);
-			enemies[enemies.size() - 1]->setPosition(glm::vec2(pos.x * map->getTileSize(), pos.y * map->getTileSize() + enemies[enemies.size() - 1]->getSize().y / 2));
-			enemies[enemies.size() - 1]->setTileMap(map);
+		collisions.init(float(CAMERA_WIDTH + 2 * ACTIVATION_MARGIN));
+		projectiles.init();
+		player->setProjectiles(&projectiles);
+		enemies.init(entities, projectiles, random);
+		enemies.setFireRate(settings.fireRate);
+
+		// Enemies are created when their section is streamed in
+		spawnPoints = map->getSpawnPoints("enemy");
+		stable_sort(spawnPoints.begin(), spawnPoints.end(), compareSpawnX);
+		spawnState.assign(spawnPoints.size(), SPAWN_PENDING);
+
+		if (textureLife == NULL) {
+			textureLife = TextureManager::instance().acquireRegion("images/life.png", TEXTURE_PIXEL_FORMAT_RGBA, regionLife);
+			textureLife->setMinFilter(GL_NEAREST);
+			textureLife->setMagFilter(GL_NEAREST);
 		}
-
-		textureLife.loadFromFile("images/life.png", TEXTURE_PIXEL_FORMAT_RGBA);
-		textureLife.setMinFilter(GL_NEAREST);
-		textureLife.setMagFilter(GL_NEAREST);
-		spriteLife = Sprite::createSprite(glm::ivec2(8, 16), glm::vec2(1.0f, 1.0f), &textureLife, &texProgram);
+		if (spriteLife != NULL) {
+			spriteLife->free();
+			delete spriteLife;
+		}
+		spriteLife = Sprite::createSprite(glm::ivec2(8, 16), glm::vec2(1.0f, 1.0f), regionLife, &texProgram);
 		spriteLife->setPosition(glm::vec2(SPRITELIFE_OFFSET));
 
-		textureSpreadgun.loadFromFile("images/spreadgun.png", TEXTURE_PIXEL_FORMAT_RGBA);
-		textureSpreadgun.setMinFilter(GL_NEAREST);
-		textureSpreadgun.setMagFilter(GL_NEAREST);
-		spriteSpreadgun = Sprite::createSprite(glm::ivec2(24, 15), glm::vec2(1.0f, 1.0f), &textureSpreadgun, &texProgram);
+		if (textureSpreadgun == NULL) {
+			textureSpreadgun = TextureManager::instance().acquireRegion("images/spreadgun.png", TEXTURE_PIXEL_FORMAT_RGBA, regionSpreadgun);
+			textureSpreadgun->setMinFilter(GL_NEAREST);
+			textureSpreadgun->setMagFilter(GL_NEAREST);
+		}
+		if (spriteSpreadgun != NULL) {
+			spriteSpreadgun->free();
+			delete spriteSpreadgun;
+		}
+		spriteSpreadgun = Sprite::createSprite(glm::ivec2(24, 15), glm::vec2(1.0f, 1.0f), regionSpreadgun, &texProgram);
 		spriteSpreadgun->setPosition(glm::vec2(SPREADGUN_POS_X, SPREADGUN_POS_Y));
 
+		cameraX = previousCameraX = 0.0f;
+		streamLevel();
 		projection = glm::ortho(0.0f, float(CAMERA_WIDTH), float(CAMERA_HEIGHT), 0.0f);
-		if (backgroundMusic != nullptr) {
-			backgroundMusic->stop();
-			backgroundMusic->drop();
-		}
-		backgroundMusic = soundEngine->play2D("sounds/jungle-hangar.ogg", true, false, true);
+		Game::instance().getSound().playMusic(MUSIC_LEVEL1, true);
 		break;
 	}
 	
@@ -112,22 +162,45 @@ void Scene::init()
 }
 
 void Scene::loadStaticImg(char* path) {
-	texture.loadFromFile(path, TEXTURE_PIXEL_FORMAT_RGBA);
-	texture.setMinFilter(GL_NEAREST);
-	texture.setMagFilter(GL_NEAREST);
-	sprite = Sprite::createSprite(glm::ivec2(STARTSCREEN_WIDTH, STARTSCREEN_HEIGHT), glm::vec2(1.0f, 1.0f), &texture, &texProgram);
+	// The previous screen is released after acquiring the new one, so
+	// going back to the same screen does not decode the image again
+	Texture *previous = texture;
+	AtlasRegion region;
+	texture = TextureManager::instance().acquireRegion(path, TEXTURE_PIXEL_FORMAT_RGBA, region);
+	TextureManager::instance().release(previous);
+	texture->setMinFilter(GL_NEAREST);
+	texture->setMagFilter(GL_NEAREST);
+	if (sprite != NULL) {
+		sprite->free();
+		delete sprite;
+	}
+	sprite = Sprite::createSprite(glm::ivec2(STARTSCREEN_WIDTH, STARTSCREEN_HEIGHT), glm::vec2(1.0f, 1.0f), region, &texProgram);
 	projection = glm::ortho(0.0f, float(STARTSCREEN_WIDTH), float(STARTSCREEN_HEIGHT), 0.0f);
 }
 
-void Scene::update(int deltaTime)
+void Scene::update(float deltaTime)
 {
+	PROFILE_ZONE("Scene::update");
+
 	currentTime += deltaTime;
 
+	if (loading) {
+		if (TextureManager::instance().isLoading())
+			return;
+		loading = false;
+		level = nextLevel;
+		init();
+		// The level holds its own references by now
+		for (auto preloadedTexture : preloaded)
+			TextureManager::instance().release(preloadedTexture);
+		preloaded.clear();
+		return;
+	}
+
 	switch (level) {
 	case START:
 		if (Game::instance().getKey('\r')) {
-			level = LEVEL1;
-			init();
+			changeLevel(LEVEL1);
 		} else if (Game::instance().getKey('h')) {
 			level = HELP;
 			init();
@@ -147,56 +220,66 @@ void Scene::update(int deltaTime)
 	case GAMEOVER:
 		if (Game::instance().getKey('\r')) {
 			Game::instance().keyReleased('\r');
-			level = LEVEL1;
-			init();
+			changeLevel(LEVEL1);
 		}
 		break;
 	case LEVEL1:
+		entities.updateAnimations(deltaTime);
+	{
+		PROFILE_ZONE("update player");
 		player->update(deltaTime);
+	}
 
 		float posPlayer = player->getPosition().x + player->getSize().x / 2 - CAMERA_WIDTH / 2;
 		float rightLimit = (map->getSize().x * map->getTileSize()) - CAMERA_WIDTH;
-		posPlayer = glm::clamp(posPlayer, 0.0f, rightLimit);
-		projection = glm::ortho(posPlayer, float(CAMERA_WIDTH) + posPlayer, float(CAMERA_HEIGHT), 0.0f);
-
-		spriteLife->setPosition(glm::vec2(posPlayer + SPRITELIFE_OFFSET, SPRITELIFE_OFFSET));
+		previousCameraX = cameraX;
+		cameraX = glm::clamp(posPlayer, 0.0f, rightLimit);
+		streamLevel();
 
 		glm::vec2 posP = player->getPosition() + player->getHitbox(1);
 		glm::vec2 sizeP = player->getHitbox(0);
-		for (auto enemy : enemies) {
-			enemy->setLookingDirection(enemy->getPosition().x < player->getPosition().x);
-			enemy->update(deltaTime);
-
-			for (auto bullet : enemy->getBullets()) {
-				glm::vec2 pos = bullet->getPosition();
-				if (pos.x > posP.x && pos.x < posP.x + sizeP.x &&
-					pos.y > posP.y && pos.y < player->getPosition().y + sizeP.y) {
+		{
+			PROFILE_ZONE("update enemies");
+			enemies.update(player->getPosition(), cameraX - ACTIVATION_MARGIN, cameraX + CAMERA_WIDTH + ACTIVATION_MARGIN);
+		}
+		{
+			PROFILE_ZONE("update projectiles");
+			projectiles.update(deltaTime);
+			if (settings.projectiles > 0)
+				fillProjectiles();
+		}
+
+		PROFILE_ZONE("collisions");
+
+		// Player bullets are only tested against the active enemies near them
+		const vector<int> &active = enemies.getActive();
+		int nBullets = projectiles.getUsed();
+		collisions.find(entities, active, projectiles, posP, glm::vec2(posP.x + sizeP.x, player->getPosition().y + sizeP.y), cameraX - ACTIVATION_MARGIN);
+		for (int i = 0; i < nBullets; i++) {
+			if (collisions.isPlayerHit(i)) {
+				if (!settings.invulnerable)
 					player->decreaseLife();
-					bullet->setAlive(false);
-					Game::instance().getSoundEngine()->play2D("sounds/enemyhit.wav");
-				}
+				projectiles.kill(i);
+				Game::instance().getSound().play(SOUND_ENEMY_HIT);
 			}
 		}
-		if (player->getLife() < 0) {
+		for (int h = 0; h < collisions.getNumEnemyHits(); h++)
+			Game::instance().getSound().play(SOUND_ENEMY_HIT);
+		if (player->getLife() < 0 && !settings.invulnerable) {
 			level = GAMEOVER;
 			init();
+			break;
 		}
-
-		vector<shared_ptr<Enemy>> enemiesToRemove = vector<shared_ptr<Enemy>>();
-		for (auto bullet : player->getBullets()) {
-			glm::vec2 pos = bullet->getPosition();
-			for (auto enemy : enemies) {
-				glm::vec2 posE = enemy->getPosition() + enemy->getHitbox(1);
-				glm::vec2 sizeE = enemy->getHitbox(0);
-				if (pos.x > posE.x && pos.x < posE.x + sizeE.x &&
-					pos.y > posE.y && pos.y < enemy->getPosition().y + sizeE.y) {
-					enemiesToRemove.emplace_back(enemy);
-					Game::instance().getSoundEngine()->play2D("sounds/enemyhit.wav");
-				}
-			}
-		}
-		for (auto enemyRemove : enemiesToRemove) {
-			enemies.erase(remove(enemies.begin(), enemies.end(), enemyRemove), enemies.end());
+		// Killed enemies are removed from the highest id down, so moving the
+		// last entity into a removed slot never moves one still to be removed
+		killed.clear();
+		for (unsigned int a = 0; a < active.size(); a++)
+			if (collisions.isEnemyHit(a))
+				killed.push_back(active[a]);
+		sort(killed.begin(), killed.end(), greater<int>());
+		for (unsigned int k = 0; k < killed.size(); k++) {
+			spawnState[entities.getSpawnPoint(killed[k])] = SPAWN_KILLED;
+			enemies.destroy(killed[k]);
 		}
 
 		if (!player->getSpreadgun() && SPREADGUN_POS_X > posP.x && SPREADGUN_POS_X < posP.x + sizeP.x &&
@@ -208,44 +291,138 @@ void Scene::update(int deltaTime)
 	}
 }
 
+// Keeps the map sections around the camera resident, and the enemies of
+// those sections alive. Enemies of released sections are dropped and come
+// back if the section is streamed in again; killed ones never do.
+void Scene::streamLevel()
+{
+	PROFILE_ZONE("stream level");
+
+	if (!map->streamSections(cameraX, cameraX + CAMERA_WIDTH))
+		return;
+	int first = map->getFirstResidentSection();
+	int last = map->getLastResidentSection();
+
+	for (int e = 0; e < entities.getCount();) {
+		int spawnPoint = entities.getSpawnPoint(e);
+		int section = spawnPoint != -1 ? map->getSectionOf(spawnPoints[spawnPoint].x) : first;
+		if (section < first || section > last) {
+			spawnState[spawnPoint] = SPAWN_PENDING;
+			enemies.destroy(e);
+		}
+		else
+			e++;
+	}
+	auto firstPoint = lower_bound(spawnPoints.begin(), spawnPoints.end(), first,
+		[this](const glm::vec2 &point, int section) { return map->getSectionOf(point.x) < section; });
+	for (auto point = firstPoint; point != spawnPoints.end() && map->getSectionOf(point->x) <= last; ++point) {
+		int spawnPoint = int(point - spawnPoints.begin());
+		if (spawnState[spawnPoint] == SPAWN_PENDING)
+			spawnEnemy(spawnPoint);
+	}
+}
+
+void Scene::spawnEnemy(int spawnPoint)
+{
+	glm::vec2 pos = spawnPoints[spawnPoint];
+
+	// Spawn points are at half the height of the enemy
+	if (enemies.spawn(glm::ivec2(pos.x, pos.y + ENEMY_HALF_HEIGHT), spawnPoint) != -1)
+		spawnState[spawnPoint] = SPAWN_ALIVE;
+}
+
+// Tops the bullets up to settings.projectiles around the activation window
+void Scene::fillProjectiles()
+{
+	int left = int(cameraX) - ACTIVATION_MARGIN, right = int(cameraX) + CAMERA_WIDTH + ACTIVATION_MARGIN;
+
+	projectiles.fill(settings.projectiles, glm::ivec2(left, 0), glm::ivec2(right, CAMERA_HEIGHT), random);
+}
+
+void Scene::stopLevel()
+{
+	for (auto preloadedTexture : preloaded)
+		TextureManager::instance().release(preloadedTexture);
+	preloaded.clear();
+	loading = false;
+	if (map != NULL) {
+		map->free();
+		delete map;
+		map = NULL;
+	}
+	if (player != NULL) {
+		delete player;
+		player = NULL;
+	}
+	level = nextLevel = START;
+	init();
+}
+
+// Textures of the next level are decoded in the background while the
+// current screen is still shown and updated by update()
+void Scene::changeLevel(Level next)
+{
+	LevelFile levelFile;
+
+	nextLevel = next;
+	loading = true;
+	if (next == LEVEL1 && levelFile.load(settings.levelFile))
+		preloaded.push_back(TextureManager::instance().preload(levelFile.getTilesheetFile(), TEXTURE_PIXEL_FORMAT_RGBA));
+}
+
 void Scene::render()
 {
+	PROFILE_ZONE("Scene::render");
 	glm::mat4 modelview;
 
+	// The camera and moving sprites are drawn between their last two simulated positions
+	batch.setInterpolation(Game::instance().getInterpolation());
+	if (level == LEVEL1) {
+		float camera = glm::mix(previousCameraX, cameraX, batch.getInterpolation());
+		projection = glm::ortho(camera, float(CAMERA_WIDTH) + camera, float(CAMERA_HEIGHT), 0.0f);
+		map->setVisibleRange(camera, camera + CAMERA_WIDTH);
+		spriteLife->setPosition(glm::vec2(camera + SPRITELIFE_OFFSET, SPRITELIFE_OFFSET));
+	}
 	texProgram.use();
-	texProgram.setUniformMatrix4f("projection", projection);
-	texProgram.setUniform4f("color", 1.0f, 1.0f, 1.0f, 1.0f);
+	texProgram.setUniformMatrix4f(projectionUniform, projection);
+	texProgram.setUniform4f(colorUniform, 1.0f, 1.0f, 1.0f, 1.0f);
 	modelview = glm::mat4(1.0f);
-	texProgram.setUniformMatrix4f("modelview", modelview);
-	texProgram.setUniform2f("texCoordDispl", 0.f, 0.f);
+	texProgram.setUniformMatrix4f(modelviewUniform, modelview);
+	texProgram.setUniform2f(texCoordDisplUniform, 0.f, 0.f);
 	switch (level) {
 	case START:
 	case HELP:
 	case CREDITS:
 	case GAMEOVER:
-		sprite->render();
+		batch.begin();
+		sprite->render(batch);
+		batch.end();
 		break;
 	case LEVEL1:
 		map->render();
-		player->render();
-		for (auto enemy : enemies) {
-			enemy->render();
-		}
-		spriteSpreadgun->render();
+		batch.begin();
+		projectiles.render(batch);
+		entities.render(batch);
+		spriteSpreadgun->render(batch);
+		glm::vec2 lifePos = spriteLife->getPosition();
 		for (int i = 0; i < player->getLife(); i++) {
-			if (i > 0) {
-				spriteLife->setPosition(spriteLife->getPosition() + glm::vec2(16.0f, 0.0f));
-			}
-			spriteLife->render();
+			spriteLife->setPosition(lifePos + glm::vec2(16.0f * i, 0.0f));
+			spriteLife->render(batch, LAYER_HUD);
 		}
+		spriteLife->setPosition(lifePos);
+		batch.end();
 	break;
 	}
 }
 
 void Scene::initShaders()
 {
+	PROFILE_ZONE("load shaders");
 	Shader vShader, fShader;
 
+	// The program survives state changes, sprites keep pointers to it
+	if(texProgram.isLinked())
+		return;
 	vShader.initFromFile(VERTEX_SHADER, "shaders/texture.vert");
 	if(!vShader.isCompiled())
 	{
@@ -270,6 +447,10 @@ void Scene::initShaders()
 	texProgram.bindFragmentOutput("outColor");
 	vShader.free();
 	fShader.free();
+	projectionUniform = texProgram.getUniformHandle("projection");
+	colorUniform = texProgram.getUniformHandle("color");
+	modelviewUniform = texProgram.getUniformHandle("modelview");
+	texCoordDisplUniform = texProgram.getUniformHandle("texCoordDispl");
 }
 
 
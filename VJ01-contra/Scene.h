@@ -3,11 +3,14 @@
 
 
 #include <glm/glm.hpp>
-#include <irrKlang.h>
 #include "ShaderProgram.h"
+#include "Sprite.h"
 #include "TileMap.h"
 #include "Player.h"
-#include "Enemy.h"
+#include "EntityStore.h"
+#include "EnemySystem.h"
+#include "ProjectileSystem.h"
+#include "ProjectileCollisions.h"
 
 
 // Scene contains all the entities of our game.
@@ -15,6 +18,21 @@
 
 enum Level { START, HELP, CREDITS, LEVEL1, GAMEOVER };
 
+
+// Overrides of the level used by the stress test in Headless.
+// The defaults play the real level.
+
+struct LevelSettings
+{
+	string levelFile;
+	float fireRate;       // Multiplies how often enemies shoot
+	int projectiles;      // Bullets kept in flight around the camera, 0 for none
+	bool invulnerable;    // Neither hits nor falls end the game
+
+	LevelSettings();
+};
+
+
 class Scene
 {
 
@@ -23,28 +41,60 @@ public:
 	~Scene();
 
 	void init();
-	void update(int deltaTime);
+	void update(float deltaTime);
 	void render();
 
+	// True while the current screen waits for the next level's assets
+	bool isLoading() const { return loading; }
+	// Settings are used from the next time the level starts
+	void setLevelSettings(const LevelSettings &levelSettings) { settings = levelSettings; }
+	void startLevel() { changeLevel(LEVEL1); }
+	// Goes back to the start screen, freeing the level and closing its file
+	void stopLevel();
+
+	// Shared with overlays drawn over the scene
+	ShaderProgram &getTexProgram() { return texProgram; }
+	int getLiveProjectiles() const { return projectiles.getLiveCount(); }
+	// Enemies alive in the level and those being updated, 0 out of it
+	int getEnemyCount() const { return level == LEVEL1 ? entities.getCount() - 1 : 0; }
+	int getActiveEnemyCount() const { return level == LEVEL1 ? int(enemies.getActive().size()) : 0; }
+
 private:
 	void initShaders();
+	void changeLevel(Level next);
+	void streamLevel();
+	void spawnEnemy(int spawnPoint);
+	void fillProjectiles();
 	void loadStaticImg(char* path);
 
 private:
-	Level level;
-	Texture texture;
-	Texture textureLife;
-	Texture textureSpreadgun;
+	Level level, nextLevel;
+	LevelSettings settings;
+	bool loading;
+	vector<Texture *> preloaded;
+	Texture *texture;
+	Texture *textureLife;
+	Texture *textureSpreadgun;
+	AtlasRegion regionLife, regionSpreadgun;
 	Sprite *sprite;
 	Sprite *spriteLife;
 	Sprite *spriteSpreadgun;
 	TileMap *map;
 	Player *player;
-	vector<shared_ptr<Enemy>> enemies;
+	EntityStore entities;
+	EnemySystem enemies;
+	ProjectileSystem projectiles;
+	Random random;
+	ProjectileCollisions collisions;
+	vector<int> killed;
+	vector<glm::vec2> spawnPoints;       // Enemy spawn points sorted by x
+	vector<unsigned char> spawnState;
+	SpriteBatch batch;
 	ShaderProgram texProgram;
+	UniformHandle projectionUniform, colorUniform, modelviewUniform, texCoordDisplUniform;
 	float currentTime;
 	glm::mat4 projection;
-	irrklang::ISound* backgroundMusic;
+	float cameraX, previousCameraX;
 
 };
 
@@ -1,5 +1,7 @@
+#include <cstring>
 #include <glm/gtc/type_ptr.hpp>
 #include "ShaderProgram.h"
+#include "RenderState.h"
 
 
 ShaderProgram::ShaderProgram()
@@ -44,16 +46,45 @@ void ShaderProgram::link()
 	linked = (status == GL_TRUE);
 	glGetProgramInfoLog(programId, 512, NULL, buffer);
 	errorLog.assign(buffer);
+	loadUniformLocations();
+}
+
+void ShaderProgram::loadUniformLocations()
+{
+	GLint nUniforms, size;
+	GLenum type;
+	char name[256];
+
+	uniforms.clear();
+	uniformSlots.clear();
+	if(!linked)
+		return;
+	glGetProgramiv(programId, GL_ACTIVE_UNIFORMS, &nUniforms);
+	for(GLint i=0; i<nUniforms; i++)
+	{
+		glGetActiveUniform(programId, i, sizeof(name), NULL, &size, &type, name);
+		// Arrays are reported as "name[0]"
+		char *bracket = strchr(name, '[');
+		if(bracket != NULL)
+			*bracket = '\0';
+
+		UniformSlot slot;
+		slot.location = glGetUniformLocation(programId, name);
+		slot.valid = false;
+		uniformSlots[name] = int(uniforms.size());
+		uniforms.push_back(slot);
+	}
 }
 
 void ShaderProgram::free()
 {
+	RenderState::instance().forgetProgram(programId);
 	glDeleteProgram(programId);
 }
 
 void ShaderProgram::use()
 {
-	glUseProgram(programId);
+	RenderState::instance().useProgram(programId);
 }
 
 bool ShaderProgram::isLinked()
@@ -66,35 +97,74 @@ const string &ShaderProgram::log() const
 	return errorLog;
 }
 
-void ShaderProgram::setUniform2f(const string &uniformName, float v0, float v1)
+UniformHandle ShaderProgram::getUniformHandle(const string &uniformName) const
 {
-	GLint location = glGetUniformLocation(programId, uniformName.c_str());
+	map<string, int>::const_iterator it = uniformSlots.find(uniformName);
 
-	if(location != -1)
-		glUniform2f(location, v0, v1);
+	if(it == uniformSlots.end())
+		return UniformHandle();
+	return UniformHandle(it->second);
 }
 
-void ShaderProgram::setUniform3f(const string &uniformName, float v0, float v1, float v2)
+bool ShaderProgram::isUniformUpToDate(UniformHandle uniform, const float *values, int nValues)
 {
-	GLint location = glGetUniformLocation(programId, uniformName.c_str());
+	UniformSlot &slot = uniforms[uniform.slot];
+
+	if(slot.valid && memcmp(slot.value, values, nValues * sizeof(float)) == 0)
+		return true;
+	memcpy(slot.value, values, nValues * sizeof(float));
+	slot.valid = true;
 
-	if(location != -1)
-		glUniform3f(location, v0, v1, v2);
+	return false;
 }
 
-void ShaderProgram::setUniform4f(const string &uniformName, float v0, float v1, float v2, float v3)
+void ShaderProgram::setUniform2f(UniformHandle uniform, float v0, float v1)
 {
-	GLint location = glGetUniformLocation(programId, uniformName.c_str());
+	float values[2] = {v0, v1};
 
-	if(location != -1)
-		glUniform4f(location, v0, v1, v2, v3);
+	if(uniform.isValid() && !isUniformUpToDate(uniform, values, 2))
+		glUniform2f(uniforms[uniform.slot].location, v0, v1);
 }
 
-void ShaderProgram::setUniformMatrix4f(const string &uniformName, glm::mat4 &mat)
+void ShaderProgram::setUniform3f(UniformHandle uniform, float v0, float v1, float v2)
 {
-	GLint location = glGetUniformLocation(programId, uniformName.c_str());
+	float values[3] = {v0, v1, v2};
 
-	if(location != -1)
-		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
+	if(uniform.isValid() && !isUniformUpToDate(uniform, values, 3))
+		glUniform3f(uniforms[uniform.slot].location, v0, v1, v2);
+}
+
+void ShaderProgram::setUniform4f(UniformHandle uniform, float v0, float v1, float v2, float v3)
+{
+	float values[4] = {v0, v1, v2, v3};
+
+	if(uniform.isValid() && !isUniformUpToDate(uniform, values, 4))
+		glUniform4f(uniforms[uniform.slot].location, v0, v1, v2, v3);
+}
+
+void ShaderProgram::setUniformMatrix4f(UniformHandle uniform, const glm::mat4 &mat)
+{
+	if(uniform.isValid() && !isUniformUpToDate(uniform, glm::value_ptr(mat), 16))
+		glUniformMatrix4fv(uniforms[uniform.slot].location, 1, GL_FALSE, glm::value_ptr(mat));
+}
+
+void ShaderProgram::setUniform2f(const string &uniformName, float v0, float v1)
+{
+	setUniform2f(getUniformHandle(uniformName), v0, v1);
+}
+
+void ShaderProgram::setUniform3f(const string &uniformName, float v0, float v1, float v2)
+{
+	setUniform3f(getUniformHandle(uniformName), v0, v1, v2);
+}
+
+void ShaderProgram::setUniform4f(const string &uniformName, float v0, float v1, float v2, float v3)
+{
+	setUniform4f(getUniformHandle(uniformName), v0, v1, v2, v3);
+}
+
+void ShaderProgram::setUniformMatrix4f(const string &uniformName, const glm::mat4 &mat)
+{
+	setUniformMatrix4f(getUniformHandle(uniformName), mat);
 }
 
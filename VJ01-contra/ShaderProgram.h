@@ -2,12 +2,27 @@
 #define _SHADER_PROGRAM_INCLUDE
 
 
+#include <map>
+#include <vector>
 #include <GL/glew.h>
 #include <GL/gl.h>
 #include <glm/glm.hpp>
 #include "Shader.h"
 
 
+// Handle to an active uniform, resolved once after linking. Setting a
+// uniform through its handle needs no string work nor OpenGL queries.
+
+struct UniformHandle
+{
+	int slot;
+
+	UniformHandle() : slot(-1) {}
+	explicit UniformHandle(int s) : slot(s) {}
+	bool isValid() const { return slot != -1; }
+};
+
+
 // Using the Shader class ShaderProgram can link a vertex and a fragment shader
 // together, bind input attributes to their corresponding vertex shader names, 
 // and bind the fragment output to a name from the fragment shader
@@ -28,19 +43,42 @@ public:
 
 	void use();
 
-	// Pass uniforms to the associated shaders
+	// Uniform locations are queried once when the program is linked
+	UniformHandle getUniformHandle(const string &uniformName) const;
+
+	// Pass uniforms to the associated shaders. Values equal to the ones
+	// last uploaded for the same uniform are not sent again.
+	void setUniform2f(UniformHandle uniform, float v0, float v1);
+	void setUniform3f(UniformHandle uniform, float v0, float v1, float v2);
+	void setUniform4f(UniformHandle uniform, float v0, float v1, float v2, float v3);
+	void setUniformMatrix4f(UniformHandle uniform, const glm::mat4 &mat);
+
 	void setUniform2f(const string &uniformName, float v0, float v1);
 	void setUniform3f(const string &uniformName, float v0, float v1, float v2);
 	void setUniform4f(const string &uniformName, float v0, float v1, float v2, float v3);
-	void setUniformMatrix4f(const string &uniformName, glm::mat4 &mat);
+	void setUniformMatrix4f(const string &uniformName, const glm::mat4 &mat);
 
 	bool isLinked();
 	const string &log() const;
 
+private:
+	void loadUniformLocations();
+	bool isUniformUpToDate(UniformHandle uniform, const float *values, int nValues);
+
+private:
+	struct UniformSlot
+	{
+		GLint location;
+		bool valid;
+		float value[16];
+	};
+
 private:
 	GLuint programId;
 	bool linked;
 	string errorLog;
+	vector<UniformSlot> uniforms;
+	map<string, int> uniformSlots;
 
 };
 
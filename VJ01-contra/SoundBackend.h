@@ -0,0 +1,53 @@
+#ifndef _SOUND_BACKEND_INCLUDE
+#define _SOUND_BACKEND_INCLUDE
+
+
+#include <string>
+
+
+using namespace std;
+
+
+// SoundBackend is the interface SoundSystem plays sounds through. Sounds
+// are loaded once into numbered slots and played on numbered voices, so
+// the backend never looks anything up by filename while the game runs.
+
+
+class SoundBackend
+{
+
+public:
+	virtual ~SoundBackend() {}
+
+	virtual bool init(int nSounds, int nVoices) = 0;
+	virtual void free() = 0;
+
+	// Streamed sounds are decoded while they play, the rest are preloaded
+	virtual bool load(int sound, const string &filename, bool stream) = 0;
+	// Starts sound on voice, which must not be playing
+	virtual void play(int sound, int voice, bool looped) = 0;
+	virtual void stop(int voice) = 0;
+	virtual bool isPlaying(int voice) const = 0;
+
+};
+
+
+// Plays nothing, for headless runs and machines without audio
+
+class NullSoundBackend : public SoundBackend
+{
+
+public:
+	bool init(int nSounds, int nVoices) { return true; }
+	void free() {}
+
+	bool load(int sound, const string &filename, bool stream) { return true; }
+	void play(int sound, int voice, bool looped) {}
+	void stop(int voice) {}
+	bool isPlaying(int voice) const { return false; }
+
+};
+
+
+#endif // _SOUND_BACKEND_INCLUDE
+
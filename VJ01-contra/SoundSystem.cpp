@@ -0,0 +1,122 @@
+#include "SoundSystem.h"
+
+
+#define MUSIC_VOICE MAX_VOICES
+
+
+static const char *soundFiles[NUM_SOUNDS] = {
+	"sounds/shoot.wav", "sounds/enemyhit.wav",
+	"sounds/intro.ogg", "sounds/gameover.ogg", "sounds/jungle-hangar.ogg"
+};
+
+
+SoundSystem::SoundSystem()
+{
+	backend = NULL;
+	tick = 0;
+	for(int sound=0; sound<NUM_SOUNDS; sound++)
+		pending[sound] = false;
+	for(int voice=0; voice<MAX_VOICES; voice++)
+	{
+		voiceSound[voice] = -1;
+		voiceStart[voice] = 0;
+	}
+}
+
+SoundSystem::~SoundSystem()
+{
+	free();
+}
+
+
+void SoundSystem::init(SoundBackend *soundBackend)
+{
+	free();
+	backend = soundBackend;
+	// Without a sound device the game goes on silently
+	if(!backend->init(NUM_SOUNDS, MAX_VOICES + 1))
+	{
+		delete backend;
+		backend = new NullSoundBackend();
+		backend->init(NUM_SOUNDS, MAX_VOICES + 1);
+	}
+	// Music is streamed, effects are decoded now so that playing them is instant
+	for(int sound=0; sound<NUM_SOUNDS; sound++)
+		backend->load(sound, soundFiles[sound], sound >= MUSIC_INTRO);
+}
+
+void SoundSystem::free()
+{
+	if(backend == NULL)
+		return;
+	backend->free();
+	delete backend;
+	backend = NULL;
+}
+
+void SoundSystem::play(SoundId sound)
+{
+	pending[sound] = true;
+}
+
+void SoundSystem::update()
+{
+	if(backend == NULL)
+		return;
+	for(int sound=0; sound<NUM_SOUNDS; sound++)
+	{
+		if(!pending[sound])
+			continue;
+		int voice = allocateVoice();
+		backend->play(sound, voice, false);
+		voiceSound[voice] = sound;
+		voiceStart[voice] = tick;
+		pending[sound] = false;
+	}
+	tick++;
+}
+
+void SoundSystem::playMusic(SoundId music, bool looped)
+{
+	if(backend == NULL)
+		return;
+	backend->stop(MUSIC_VOICE);
+	backend->play(music, MUSIC_VOICE, looped);
+}
+
+void SoundSystem::stopMusic()
+{
+	if(backend != NULL)
+		backend->stop(MUSIC_VOICE);
+}
+
+int SoundSystem::getPlayingVoices() const
+{
+	int nPlaying = 0;
+
+	for(int voice=0; voice<=MAX_VOICES && backend != NULL; voice++)
+	{
+		if(backend->isPlaying(voice))
+			nPlaying++;
+	}
+
+	return nPlaying;
+}
+
+// A free voice if there is one, otherwise the oldest one is stopped
+int SoundSystem::allocateVoice()
+{
+	int oldest = 0;
+
+	for(int voice=0; voice<MAX_VOICES; voice++)
+	{
+		if(voiceSound[voice] == -1 || !backend->isPlaying(voice))
+			return voice;
+		if(tick - voiceStart[voice] > tick - voiceStart[oldest])
+			oldest = voice;
+	}
+	backend->stop(oldest);
+
+	return oldest;
+}
+
@@ -0,0 +1,61 @@
+#ifndef _SOUND_SYSTEM_INCLUDE
+#define _SOUND_SYSTEM_INCLUDE
+
+
+#include "SoundBackend.h"
+
+
+// Every sound of the game. Their files are listed in SoundSystem.cpp.
+
+enum SoundId
+{
+	SOUND_SHOOT, SOUND_ENEMY_HIT,
+	MUSIC_INTRO, MUSIC_GAMEOVER, MUSIC_LEVEL1,
+	NUM_SOUNDS
+};
+
+
+#define MAX_VOICES 8
+
+
+// SoundSystem owns the sound bank and a fixed pool of voices. Effects
+// are requested with play and started by update, once per tick, so an
+// effect requested many times in a tick (e.g. several hits) only plays
+// once. When every voice is busy the one that has played the longest is
+// stolen. Music has a voice of its own that effects never take.
+
+
+class SoundSystem
+{
+
+public:
+	SoundSystem();
+	~SoundSystem();
+
+	// Takes ownership of the backend and loads the whole bank
+	void init(SoundBackend *soundBackend);
+	void free();
+
+	void play(SoundId sound);
+	void update();
+
+	void playMusic(SoundId music, bool looped);
+	void stopMusic();
+
+	int getPlayingVoices() const;
+
+private:
+	int allocateVoice();
+
+private:
+	SoundBackend *backend;
+	bool pending[NUM_SOUNDS];
+	int voiceSound[MAX_VOICES];       // -1 if the voice has never played
+	unsigned int voiceStart[MAX_VOICES];
+	unsigned int tick;
+
+};
+
+
+#endif // _SOUND_SYSTEM_INCLUDE
+
@@ -2,6 +2,20 @@
 #include <GL/gl.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include "Sprite.h"
+#include "RenderStats.h"
+#include "RenderState.h"
+
+
+static AtlasRegion wholeTexture(Texture *texture)
+{
+	AtlasRegion region;
+
+	region.texture = texture;
+	region.uvOffset = glm::vec2(0.f, 0.f);
+	region.uvScale = glm::vec2(1.f, 1.f);
+
+	return region;
+}
 
 
 Sprite *Sprite::createSprite(const glm::vec2 &quadSize, const glm::vec2 &sizeInSpritesheet, Texture *spritesheet, ShaderProgram *program)
@@ -11,31 +25,58 @@ Sprite *Sprite::createSprite(const glm::vec2 &quadSize, const glm::vec2 &sizeInS
 	return quad;
 }
 
+Sprite *Sprite::createSprite(const glm::vec2 &quadSize, const glm::vec2 &sizeInSpritesheet, const AtlasRegion &region, ShaderProgram *program)
+{
+	Sprite *quad = new Sprite(quadSize, sizeInSpritesheet, region, program);
+
+	return quad;
+}
+
 
-Sprite::Sprite(const glm::vec2 &quadSize, const glm::vec2 &sizeInSpritesheet, Texture *spritesheet, ShaderProgram *program)
+Sprite::Sprite(const glm::vec2 &quadSize, const glm::vec2 &sizeInSpritesheet, Texture *spritesheet, ShaderProgram *program) :
+	Sprite(quadSize, sizeInSpritesheet, wholeTexture(spritesheet), program)
 {
+}
+
+Sprite::Sprite(const glm::vec2 &quadSize, const glm::vec2 &sizeInSpritesheet, const AtlasRegion &region, ShaderProgram *program)
+{
+	glm::vec2 texSize = sizeInSpritesheet * region.uvScale;
 	float vertices[24] = {0.f, 0.f, 0.f, 0.f, 
-												quadSize.x, 0.f, sizeInSpritesheet.x, 0.f, 
-												quadSize.x, quadSize.y, sizeInSpritesheet.x, sizeInSpritesheet.y, 
+												quadSize.x, 0.f, texSize.x, 0.f, 
+												quadSize.x, quadSize.y, texSize.x, texSize.y, 
 												0.f, 0.f, 0.f, 0.f, 
-												quadSize.x, quadSize.y, sizeInSpritesheet.x, sizeInSpritesheet.y, 
-												0.f, quadSize.y, 0.f, sizeInSpritesheet.y};
+												quadSize.x, quadSize.y, texSize.x, texSize.y, 
+												0.f, quadSize.y, 0.f, texSize.y};
 
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	RenderState::instance().bindVertexArray(vao);
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
 	glBufferData(GL_ARRAY_BUFFER, 24 * sizeof(float), vertices, GL_STATIC_DRAW);
 	posLocation = program->bindVertexAttribute("position", 2, 4*sizeof(float), 0);
 	texCoordLocation = program->bindVertexAttribute("texCoord", 2, 4*sizeof(float), (void *)(2*sizeof(float)));
-	texture = spritesheet;
+	// Enabled arrays are part of the vertex array state
+	glEnableVertexAttribArray(posLocation);
+	glEnableVertexAttribArray(texCoordLocation);
+	modelviewUniform = program->getUniformHandle("modelview");
+	texCoordDisplUniform = program->getUniformHandle("texCoordDispl");
+	texture = region.texture;
 	shaderProgram = program;
+	this->quadSize = quadSize;
+	this->sizeInSpritesheet = texSize;
+	uvOffset = region.uvOffset;
+	uvScale = region.uvScale;
+	texCoordDispl = uvOffset;
 	currentAnimation = -1;
 	position = glm::vec2(0.f);
+	previousPosition = position;
+	interpolated = false;
 }
 
-void Sprite::update(int deltaTime)
+void Sprite::update(float deltaTime)
 {
+	previousPosition = position;
+	interpolated = true;
 	if(currentAnimation >= 0)
 	{
 		timeAnimation += deltaTime;
@@ -51,20 +92,26 @@ void Sprite::update(int deltaTime)
 void Sprite::render() const
 {
 	glm::mat4 modelview = glm::translate(glm::mat4(1.0f), glm::vec3(position.x, position.y, 0.f));
-	shaderProgram->setUniformMatrix4f("modelview", modelview);
-	shaderProgram->setUniform2f("texCoordDispl", texCoordDispl.x, texCoordDispl.y);
-	glEnable(GL_TEXTURE_2D);
+	shaderProgram->setUniformMatrix4f(modelviewUniform, modelview);
+	shaderProgram->setUniform2f(texCoordDisplUniform, texCoordDispl.x, texCoordDispl.y);
 	texture->use();
-	glBindVertexArray(vao);
-	glEnableVertexAttribArray(posLocation);
-	glEnableVertexAttribArray(texCoordLocation);
+	RenderState::instance().bindVertexArray(vao);
 	glDrawArrays(GL_TRIANGLES, 0, 6);
-	glDisable(GL_TEXTURE_2D);
+	RenderStats::instance().addDrawCall(6);
+}
+
+void Sprite::render(SpriteBatch &batch, BatchLayer layer) const
+{
+	glm::vec2 pos = interpolated ? glm::mix(previousPosition, position, batch.getInterpolation()) : position;
+
+	batch.draw(texture, pos, quadSize, texCoordDispl, texCoordDispl + sizeInSpritesheet, layer);
 }
 
 void Sprite::free()
 {
 	glDeleteBuffers(1, &vbo);
+	RenderState::instance().forgetVertexArray(vao);
+	glDeleteVertexArrays(1, &vao);
 }
 
 void Sprite::setNumberAnimations(int nAnimations)
@@ -82,7 +129,7 @@ void Sprite::setAnimationSpeed(int animId, int keyframesPerSec)
 void Sprite::addKeyframe(int animId, const glm::vec2 &displacement)
 {
 	if(animId < int(animations.size()))
-		animations[animId].keyframeDispl.push_back(displacement);
+		animations[animId].keyframeDispl.push_back(uvOffset + displacement * uvScale);
 }
 
 void Sprite::changeAnimation(int animId)
@@ -5,7 +5,9 @@
 #include <vector>
 #include <glm/glm.hpp>
 #include "Texture.h"
+#include "TextureAtlas.h"
 #include "ShaderProgram.h"
+#include "SpriteBatch.h"
 #include "AnimKeyframes.h"
 
 
@@ -19,11 +21,18 @@ class Sprite
 public:
 	// Textured quads can only be created inside an OpenGL context
 	static Sprite *createSprite(const glm::vec2 &quadSize, const glm::vec2 &sizeInSpritesheet, Texture *spritesheet, ShaderProgram *program);
+	// Sprites created from an atlas region use spritesheet coordinates relative
+	// to their own image, they are translated to atlas coordinates internally
+	static Sprite *createSprite(const glm::vec2 &quadSize, const glm::vec2 &sizeInSpritesheet, const AtlasRegion &region, ShaderProgram *program);
 
 	Sprite(const glm::vec2 &quadSize, const glm::vec2 &sizeInSpritesheet, Texture *spritesheet, ShaderProgram *program);
+	Sprite(const glm::vec2 &quadSize, const glm::vec2 &sizeInSpritesheet, const AtlasRegion &region, ShaderProgram *program);
 
-	void update(int deltaTime);
+	// Each update starts a simulation tick. Sprites that are updated are drawn
+	// by the batch interpolating between their last two positions.
+	void update(float deltaTime);
 	void render() const;
+	void render(SpriteBatch &batch, BatchLayer layer = LAYER_WORLD) const;
 	void free();
 
 	void setNumberAnimations(int nAnimations);
@@ -42,7 +51,11 @@ private:
 	GLuint vao;
 	GLuint vbo;
 	GLint posLocation, texCoordLocation;
-	glm::vec2 position;
+	UniformHandle modelviewUniform, texCoordDisplUniform;
+	glm::vec2 position, previousPosition;
+	bool interpolated;
+	glm::vec2 quadSize, sizeInSpritesheet;
+	glm::vec2 uvOffset, uvScale;
 	int currentAnimation, currentKeyframe;
 	float timeAnimation;
 	glm::vec2 texCoordDispl;
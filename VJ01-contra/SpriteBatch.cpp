@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <GL/glew.h>
+#include <GL/gl.h>
+#include "SpriteBatch.h"
+#include "RenderStats.h"
+#include "RenderState.h"
+
+
+#define INITIAL_QUAD_CAPACITY 256
+
+
+SpriteBatch::SpriteBatch()
+{
+	vao = 0;
+	vbo = 0;
+	bufferCapacity = 0;
+	interpolation = 1.f;
+	shaderProgram = NULL;
+}
+
+
+void SpriteBatch::init(ShaderProgram &program)
+{
+	shaderProgram = &program;
+	modelviewUniform = program.getUniformHandle("modelview");
+	texCoordDisplUniform = program.getUniformHandle("texCoordDispl");
+	if(vao != 0)
+		return;
+	quads.reserve(INITIAL_QUAD_CAPACITY);
+	sortedQuads.reserve(INITIAL_QUAD_CAPACITY);
+	vertices.reserve(24 * INITIAL_QUAD_CAPACITY);
+
+	glGenVertexArrays(1, &vao);
+	RenderState::instance().bindVertexArray(vao);
+	glGenBuffers(1, &vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	bufferCapacity = INITIAL_QUAD_CAPACITY;
+	glBufferData(GL_ARRAY_BUFFER, 24 * bufferCapacity * sizeof(float), NULL, GL_STREAM_DRAW);
+	posLocation = program.bindVertexAttribute("position", 2, 4*sizeof(float), 0);
+	texCoordLocation = program.bindVertexAttribute("texCoord", 2, 4*sizeof(float), (void *)(2*sizeof(float)));
+	glEnableVertexAttribArray(posLocation);
+	glEnableVertexAttribArray(texCoordLocation);
+}
+
+void SpriteBatch::free()
+{
+	glDeleteBuffers(1, &vbo);
+	RenderState::instance().forgetVertexArray(vao);
+	glDeleteVertexArrays(1, &vao);
+	vao = 0;
+	vbo = 0;
+}
+
+void SpriteBatch::begin()
+{
+	quads.clear();
+}
+
+void SpriteBatch::draw(Texture *texture, const glm::vec2 &pos, const glm::vec2 &size, const glm::vec2 &texCoord0, const glm::vec2 &texCoord1, BatchLayer layer)
+{
+	Quad quad;
+	float *v = quad.vertices;
+
+	quad.texture = texture;
+	quad.layer = layer;
+	quad.order = int(quads.size());
+	// First triangle
+	v[0] = pos.x; v[1] = pos.y; v[2] = texCoord0.x; v[3] = texCoord0.y;
+	v[4] = pos.x + size.x; v[5] = pos.y; v[6] = texCoord1.x; v[7] = texCoord0.y;
+	v[8] = pos.x + size.x; v[9] = pos.y + size.y; v[10] = texCoord1.x; v[11] = texCoord1.y;
+	// Second triangle
+	v[12] = pos.x; v[13] = pos.y; v[14] = texCoord0.x; v[15] = texCoord0.y;
+	v[16] = pos.x + size.x; v[17] = pos.y + size.y; v[18] = texCoord1.x; v[19] = texCoord1.y;
+	v[20] = pos.x; v[21] = pos.y + size.y; v[22] = texCoord0.x; v[23] = texCoord1.y;
+	quads.push_back(quad);
+}
+
+void SpriteBatch::end()
+{
+	glm::mat4 modelview(1.0f);
+	unsigned int i, first;
+
+	if(quads.empty())
+		return;
+
+	sortedQuads.clear();
+	for(i=0; i<quads.size(); i++)
+		sortedQuads.push_back(&quads[i]);
+	sort(sortedQuads.begin(), sortedQuads.end(), compareQuads);
+	vertices.clear();
+	for(i=0; i<sortedQuads.size(); i++)
+		vertices.insert(vertices.end(), sortedQuads[i]->vertices, sortedQuads[i]->vertices + 24);
+
+	// Orphan the previous frame's storage and stream this frame's quads
+	RenderState::instance().bindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	while(bufferCapacity < int(quads.size()))
+		bufferCapacity *= 2;
+	glBufferData(GL_ARRAY_BUFFER, 24 * bufferCapacity * sizeof(float), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(float), &vertices[0]);
+
+	shaderProgram->setUniformMatrix4f(modelviewUniform, modelview);
+	shaderProgram->setUniform2f(texCoordDisplUniform, 0.f, 0.f);
+	first = 0;
+	for(i=1; i<=sortedQuads.size(); i++)
+	{
+		// Draw a run as soon as the texture changes or the quads end
+		if(i == sortedQuads.size() || sortedQuads[i]->texture != sortedQuads[first]->texture)
+		{
+			sortedQuads[first]->texture->use();
+			glDrawArrays(GL_TRIANGLES, 6 * first, 6 * (i - first));
+			RenderStats::instance().addDrawCall(6 * (i - first));
+			first = i;
+		}
+	}
+}
+
+bool SpriteBatch::compareQuads(const Quad *q1, const Quad *q2)
+{
+	if(q1->layer != q2->layer)
+		return q1->layer < q2->layer;
+	if(q1->texture->getId() != q2->texture->getId())
+		return q1->texture->getId() < q2->texture->getId();
+	return q1->order < q2->order;
+}
+
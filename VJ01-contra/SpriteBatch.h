@@ -0,0 +1,71 @@
+#ifndef _SPRITE_BATCH_INCLUDE
+#define _SPRITE_BATCH_INCLUDE
+
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "Texture.h"
+#include "ShaderProgram.h"
+
+
+using namespace std;
+
+
+// Layers are drawn in increasing order. Inside a layer quads are
+// grouped by texture, keeping submission order for the same texture.
+
+enum BatchLayer { LAYER_WORLD, LAYER_HUD };
+
+
+// SpriteBatch collects all textured quads of a frame and draws them from a
+// single vertex buffer that is streamed once per frame. Quads are sorted by
+// layer and texture so that each run of quads sharing a texture is one draw call.
+
+
+class SpriteBatch
+{
+
+public:
+	SpriteBatch();
+
+	// Batches can only be created inside an OpenGL context
+	void init(ShaderProgram &program);
+	void free();
+
+	void begin();
+	// Fraction of a simulation tick elapsed since the last update, used to
+	// place moving quads between their previous and current positions
+	void setInterpolation(float alpha) { interpolation = alpha; }
+	float getInterpolation() const { return interpolation; }
+	void draw(Texture *texture, const glm::vec2 &pos, const glm::vec2 &size, const glm::vec2 &texCoord0, const glm::vec2 &texCoord1, BatchLayer layer = LAYER_WORLD);
+	void end();
+
+	int getQuadCount() const { return int(quads.size()); }
+
+private:
+	struct Quad
+	{
+		Texture *texture;
+		int layer, order;
+		float vertices[24];
+	};
+
+	static bool compareQuads(const Quad *q1, const Quad *q2);
+
+private:
+	GLuint vao;
+	GLuint vbo;
+	GLint posLocation, texCoordLocation;
+	UniformHandle modelviewUniform, texCoordDisplUniform;
+	int bufferCapacity;
+	float interpolation;
+	ShaderProgram *shaderProgram;
+	vector<Quad> quads;
+	vector<const Quad *> sortedQuads;
+	vector<float> vertices;
+
+};
+
+
+#endif // _SPRITE_BATCH_INCLUDE
+
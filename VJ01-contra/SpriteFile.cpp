@@ -0,0 +1,68 @@
+#include <fstream>
+#include <sstream>
+#include "SpriteFile.h"
+
+
+// Reads the values of the next line, ignoring the comments after them
+static bool readLine(ifstream &fin, stringstream &sstream)
+{
+	string line;
+
+	if(!getline(fin, line))
+		return false;
+	sstream.clear();
+	sstream.str(line);
+
+	return true;
+}
+
+
+bool SpriteFile::load(const string &filename)
+{
+	ifstream fin;
+	string line;
+	stringstream sstream;
+	glm::ivec2 nFrames;
+	int nAnimations;
+
+	animations.clear();
+	fin.open(filename.c_str());
+	if(!fin.is_open())
+		return false;
+	getline(fin, line);
+	if(line.compare(0, 6, "SPRITE") != 0)
+		return false;
+	if(!readLine(fin, sstream) || !(sstream >> spritesheetFile))
+		return false;
+	if(!readLine(fin, sstream) || !(sstream >> quadSize.x >> quadSize.y))
+		return false;
+	if(!readLine(fin, sstream) || !(sstream >> nFrames.x >> nFrames.y) || nFrames.x <= 0 || nFrames.y <= 0)
+		return false;
+	if(!readLine(fin, sstream) || !(sstream >> nAnimations) || nAnimations <= 0)
+		return false;
+	frameSize = glm::vec2(1.f / nFrames.x, 1.f / nFrames.y);
+
+	animations.resize(nAnimations);
+	for(int anim=0; anim<nAnimations; anim++)
+	{
+		int keyframesPerSec, nKeyframes;
+
+		if(!readLine(fin, sstream) || !(sstream >> keyframesPerSec >> nKeyframes) || keyframesPerSec <= 0 || nKeyframes <= 0)
+			return false;
+		animations[anim].millisecsPerKeyframe = 1000.f / keyframesPerSec;
+		for(int i=0; i<nKeyframes; i++)
+		{
+			glm::ivec2 frame, hitboxOffset, hitboxSize;
+
+			if(!readLine(fin, sstream) || !(sstream >> frame.x >> frame.y >> hitboxOffset.x >> hitboxOffset.y >> hitboxSize.x >> hitboxSize.y))
+				return false;
+			animations[anim].keyframeDispl.push_back(glm::vec2(float(frame.x) / nFrames.x, float(frame.y) / nFrames.y));
+			animations[anim].hitboxOffset.push_back(hitboxOffset);
+			animations[anim].hitboxSize.push_back(hitboxSize);
+		}
+	}
+	fin.close();
+
+	return true;
+}
+
@@ -0,0 +1,53 @@
+#ifndef _SPRITE_FILE_INCLUDE
+#define _SPRITE_FILE_INCLUDE
+
+
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "AnimKeyframes.h"
+
+
+using namespace std;
+
+
+// SpriteFile holds the description of an animated spritesheet: the image,
+// the size of the quad, the grid of frames and, for every animation, its
+// speed and the frame and hitbox of each keyframe. Keyframe displacements
+// are in texture coordinates of the whole image; users owning an atlas
+// region still have to map them into it.
+//
+// Text format (see images/main_character.txt), "--" starts a comment:
+//   SPRITE
+//   spritesheet image
+//   quad width & height
+//   number of frames in the spritesheet, horizontally & vertically
+//   number of animations
+//   for every animation:
+//     keyframes per second & number of keyframes
+//     one line per keyframe: frame column & row, hitbox offset x & y, hitbox width & height
+
+
+class SpriteFile
+{
+
+public:
+	bool load(const string &filename);
+
+	const string &getSpritesheetFile() const { return spritesheetFile; }
+	glm::vec2 getQuadSize() const { return quadSize; }
+	// Size of a frame in texture coordinates
+	glm::vec2 getFrameSize() const { return frameSize; }
+	int getNumAnimations() const { return int(animations.size()); }
+	const AnimKeyframes &getAnimation(int animId) const { return animations[animId]; }
+
+private:
+	string spritesheetFile;
+	glm::vec2 quadSize, frameSize;
+	vector<AnimKeyframes> animations;
+
+};
+
+
+#endif // _SPRITE_FILE_INCLUDE
+
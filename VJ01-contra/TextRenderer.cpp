@@ -0,0 +1,91 @@
+#include <cctype>
+#include "TextRenderer.h"
+
+
+#define GLYPH_WIDTH 3
+#define GLYPH_HEIGHT 5
+// Cells leave a column and a row of spacing after each glyph
+#define CELL_WIDTH 4
+#define CELL_HEIGHT 6
+#define FIRST_GLYPH ' '
+#define NUM_GLYPHS 64
+#define ATLAS_COLUMNS 16
+
+
+// One octal digit per row, from top to bottom. The highest bit of a digit
+// is the leftmost pixel of the row.
+static const unsigned short font[NUM_GLYPHS] =
+{
+	0,      022202, 055000, 057575, 036236, 051245, 025253, 022000,   //  !"#$%&'
+	012221, 042224, 005250, 002720, 000024, 000700, 000002, 011244,   // ()*+,-./
+	075557, 026227, 071747, 071717, 055711, 074717, 074757, 071111,   // 01234567
+	075757, 075717, 002020, 002024, 012421, 007070, 042124, 071302,   // 89:;<=>?
+	075547, 025755, 065656, 034443, 065556, 074647, 074644, 034553,   // @ABCDEFG
+	055755, 072227, 011152, 055655, 044447, 057755, 065555, 025552,   // HIJKLMNO
+	065644, 025563, 065655, 034216, 072222, 055557, 055552, 055775,   // PQRSTUVW
+	055255, 055222, 071247, 064446, 044211, 031113, 025000, 000007    // XYZ[\]^_
+};
+
+
+TextRenderer::TextRenderer()
+{
+	glyphTexSize = glm::vec2(0.f);
+}
+
+
+void TextRenderer::init()
+{
+	unsigned char cell[CELL_WIDTH * CELL_HEIGHT];
+	int atlasRows = NUM_GLYPHS / ATLAS_COLUMNS;
+
+	atlas.createEmptyTexture(ATLAS_COLUMNS * CELL_WIDTH, atlasRows * CELL_HEIGHT);
+	atlas.setWrapS(GL_CLAMP_TO_EDGE);
+	atlas.setWrapT(GL_CLAMP_TO_EDGE);
+	atlas.setMinFilter(GL_NEAREST);
+	atlas.setMagFilter(GL_NEAREST);
+	for(int glyph=0; glyph<NUM_GLYPHS; glyph++)
+	{
+		for(int y=0; y<CELL_HEIGHT; y++)
+			for(int x=0; x<CELL_WIDTH; x++)
+			{
+				bool set = x < GLYPH_WIDTH && y < GLYPH_HEIGHT && ((font[glyph] >> (3 * (GLYPH_HEIGHT - 1 - y) + GLYPH_WIDTH - 1 - x)) & 1);
+				cell[y * CELL_WIDTH + x] = set ? 255 : 0;
+			}
+		atlas.loadSubtextureFromGlyphBuffer(cell, (glyph % ATLAS_COLUMNS) * CELL_WIDTH, (glyph / ATLAS_COLUMNS) * CELL_HEIGHT, CELL_WIDTH, CELL_HEIGHT);
+	}
+	glyphTexSize = glm::vec2(1.f / ATLAS_COLUMNS, 1.f / atlasRows);
+}
+
+void TextRenderer::free()
+{
+	atlas.free();
+}
+
+void TextRenderer::addText(SpriteBatch &batch, const string &text, const glm::vec2 &pos, float scale, BatchLayer layer)
+{
+	glm::vec2 cellSize = getCellSize(scale), cursor = pos;
+
+	for(unsigned int i=0; i<text.size(); i++)
+	{
+		int glyph = toupper((unsigned char)text[i]) - FIRST_GLYPH;
+
+		if(text[i] == '\n')
+		{
+			cursor = glm::vec2(pos.x, cursor.y + cellSize.y);
+			continue;
+		}
+		// Spaces and unknown characters only advance
+		if(glyph > 0 && glyph < NUM_GLYPHS)
+		{
+			glm::vec2 texCoord = glm::vec2(float(glyph % ATLAS_COLUMNS), float(glyph / ATLAS_COLUMNS)) * glyphTexSize;
+			batch.draw(&atlas, cursor, cellSize, texCoord, texCoord + glyphTexSize, layer);
+		}
+		cursor.x += cellSize.x;
+	}
+}
+
+glm::vec2 TextRenderer::getCellSize(float scale) const
+{
+	return glm::vec2(CELL_WIDTH * scale, CELL_HEIGHT * scale);
+}
+
@@ -0,0 +1,44 @@
+#ifndef _TEXT_RENDERER_INCLUDE
+#define _TEXT_RENDERER_INCLUDE
+
+
+#include <string>
+#include <glm/glm.hpp>
+#include "Texture.h"
+#include "SpriteBatch.h"
+
+
+using namespace std;
+
+
+// TextRenderer draws text with a built-in 3x5 pixel font. The glyphs of
+// the printable ASCII characters from space to '_' are written into a
+// single channel atlas at init, lowercase letters are drawn as uppercase
+// and anything else as a space. Text is added to a SpriteBatch as one quad
+// per glyph, all from the same texture, so any amount of text drawn in a
+// batch of its own is a single draw call.
+
+
+class TextRenderer
+{
+
+public:
+	TextRenderer();
+
+	// The atlas can only be created inside an OpenGL context
+	void init();
+	void free();
+
+	// Lines are separated by '\n'. Every glyph cell is scale times 4x6 pixels.
+	void addText(SpriteBatch &batch, const string &text, const glm::vec2 &pos, float scale, BatchLayer layer = LAYER_HUD);
+	glm::vec2 getCellSize(float scale) const;
+
+private:
+	Texture atlas;
+	glm::vec2 glyphTexSize;
+
+};
+
+
+#endif // _TEXT_RENDERER_INCLUDE
+
@@ -1,5 +1,6 @@
 #include <SOIL.h>
 #include "Texture.h"
+#include "RenderState.h"
 
 
 using namespace std;
@@ -7,10 +8,13 @@ using namespace std;
 
 Texture::Texture()
 {
+	texId = 0;
+	widthTex = heightTex = bytesTex = 0;
 	wrapS = GL_REPEAT;
 	wrapT = GL_REPEAT;
 	minFilter = GL_LINEAR_MIPMAP_LINEAR;
 	magFilter = GL_LINEAR_MIPMAP_LINEAR;
+	sampler = 0;
 }
 
 
@@ -29,28 +33,51 @@ bool Texture::loadFromFile(const string &filename, PixelFormat format)
 	}
 	if(image == NULL)
 		return false;
+	loadFromPixels(image, widthTex, heightTex, format);
+	SOIL_free_image_data(image);
+	
+	return true;
+}
+
+void Texture::loadFromPixels(const unsigned char *pixels, int width, int height, PixelFormat format)
+{
+	widthTex = width;
+	heightTex = height;
 	glGenTextures(1, &texId);
-	glBindTexture(GL_TEXTURE_2D, texId);
+	RenderState::instance().bindTexture(0, texId);
 	switch(format)
 	{
 	case TEXTURE_PIXEL_FORMAT_RGB:
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, widthTex, heightTex, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, widthTex, heightTex, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+		bytesTex = 3 * widthTex * heightTex;
 		break;
 	case TEXTURE_PIXEL_FORMAT_RGBA:
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, widthTex, heightTex, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, widthTex, heightTex, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+		bytesTex = 4 * widthTex * heightTex;
 		break;
 	}
 	glGenerateMipmap(GL_TEXTURE_2D);
-	
-	return true;
+}
+
+// Glyph textures only have a red channel. It is read as the alpha of a
+// white texel, so glyphs can be drawn and tinted like any other texture.
+static void setGlyphSwizzle()
+{
+	GLint swizzle[4] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+
+	glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
 }
 
 void Texture::loadFromGlyphBuffer(unsigned char *buffer, int width, int height)
 {
 	glGenTextures(1, &texId);
-	glBindTexture(GL_TEXTURE_2D, texId);
+	RenderState::instance().bindTexture(0, texId);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, buffer);
+	setGlyphSwizzle();
+	widthTex = width;
+	heightTex = height;
+	bytesTex = width * height;
 	glGenerateMipmap(GL_TEXTURE_2D);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
@@ -58,15 +85,19 @@ void Texture::loadFromGlyphBuffer(unsigned char *buffer, int width, int height)
 void Texture::createEmptyTexture(int width, int height)
 {
 	glGenTextures(1, &texId);
-	glBindTexture(GL_TEXTURE_2D, texId);
+	RenderState::instance().bindTexture(0, texId);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, 0);
+	setGlyphSwizzle();
+	widthTex = width;
+	heightTex = height;
+	bytesTex = width * height;
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
 void Texture::loadSubtextureFromGlyphBuffer(unsigned char *buffer, int x, int y, int width, int height)
 {
-	glBindTexture(GL_TEXTURE_2D, texId);
+	RenderState::instance().bindTexture(0, texId);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RED, GL_UNSIGNED_BYTE, buffer);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
@@ -74,40 +105,50 @@ void Texture::loadSubtextureFromGlyphBuffer(unsigned char *buffer, int x, int y,
 
 void Texture::generateMipmap()
 {
-	glBindTexture(GL_TEXTURE_2D, texId);
+	RenderState::instance().bindTexture(0, texId);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 	glGenerateMipmap(GL_TEXTURE_2D);
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 }
 
+void Texture::free()
+{
+	RenderState::instance().forgetTexture(texId);
+	glDeleteTextures(1, &texId);
+	texId = 0;
+}
+
 void Texture::setWrapS(GLint value)
 {
 	wrapS = value;
+	sampler = 0;
 }
 
 void Texture::setWrapT(GLint value)
 {
 	wrapT = value;
+	sampler = 0;
 }
 
 void Texture::setMinFilter(GLint value)
 {
 	minFilter = value;
+	sampler = 0;
 }
 
 void Texture::setMagFilter(GLint value)
 {
 	magFilter = value;
+	sampler = 0;
 }
 
 void Texture::use() const
 {
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, texId);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapS);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, minFilter);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, magFilter);
+	// Parameters live in a shared sampler object instead of being set on every bind
+	if(sampler == 0)
+		sampler = RenderState::instance().getSampler(wrapS, wrapT, minFilter, magFilter);
+	RenderState::instance().bindTexture(0, texId);
+	RenderState::instance().bindSampler(0, sampler);
 }
 
 
@@ -23,11 +23,13 @@ public:
 	Texture();
 
 	bool loadFromFile(const string &filename, PixelFormat format);
+	void loadFromPixels(const unsigned char *pixels, int width, int height, PixelFormat format);
 	void loadFromGlyphBuffer(unsigned char *buffer, int width, int height);
 
 	void createEmptyTexture(int width, int height);
 	void loadSubtextureFromGlyphBuffer(unsigned char *buffer, int x, int y, int width, int height);
 	void generateMipmap();
+	void free();
 	
 	void setWrapS(GLint value);
 	void setWrapT(GLint value);
@@ -38,11 +40,14 @@ public:
 	
 	int width() const { return widthTex; }
 	int height() const { return heightTex; }
+	int bytes() const { return bytesTex; }
+	GLuint getId() const { return texId; }
 
 private:
-	int widthTex, heightTex;
+	int widthTex, heightTex, bytesTex;
 	GLuint texId;
 	GLint wrapS, wrapT, minFilter, magFilter;
+	mutable GLuint sampler;
 
 };
 
@@ -0,0 +1,146 @@
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <SOIL.h>
+#include "TextureAtlas.h"
+#include "AssetLoader.h"
+
+
+using namespace std;
+
+
+// Empty texels left between images so that neighbours never bleed
+#define ATLAS_PADDING 2
+
+
+struct AtlasImage
+{
+	string filename;
+	unsigned char *pixels;
+	int width, height;
+	int page, x, y;
+};
+
+static bool compareImageHeight(const AtlasImage *img1, const AtlasImage *img2)
+{
+	return img1->height > img2->height;
+}
+
+
+TextureAtlas::TextureAtlas()
+{
+}
+
+
+bool TextureAtlas::build(const vector<string> &filenames, int pageSize)
+{
+	vector<AtlasImage> images(filenames.size());
+	vector<DecodedImage> decoded;
+	vector<AtlasImage *> sortedImages;
+	vector<unsigned char> pagePixels;
+	int x, y, shelfHeight;
+	unsigned int i;
+
+	free();
+	// Images are decoded in parallel, packing them is fast
+	AssetLoader::instance().decodeImages(filenames, TEXTURE_PIXEL_FORMAT_RGBA, decoded);
+	for(i=0; i<filenames.size(); i++)
+	{
+		AtlasImage &image = images[i];
+		image.filename = filenames[i];
+		image.pixels = decoded[i].pixels;
+		image.width = decoded[i].width;
+		image.height = decoded[i].height;
+		image.page = -1;
+		if(image.pixels == NULL)
+			cout << "Could not load atlas image " << filenames[i] << endl;
+		else if(image.width <= pageSize && image.height <= pageSize)
+			sortedImages.push_back(&image);
+	}
+	sort(sortedImages.begin(), sortedImages.end(), compareImageHeight);
+
+	// Shelf packing: images are placed left to right in rows as high as
+	// their first (tallest) image, opening a new page when one is full
+	x = y = shelfHeight = 0;
+	pagePixels.assign(4 * pageSize * pageSize, 0);
+	for(i=0; i<sortedImages.size(); i++)
+	{
+		AtlasImage &image = *sortedImages[i];
+		if(x + image.width > pageSize)
+		{
+			x = 0;
+			y += shelfHeight;
+			shelfHeight = 0;
+		}
+		if(y + image.height > pageSize)
+		{
+			pages.push_back(new Texture());
+			pages.back()->loadFromPixels(&pagePixels[0], pageSize, pageSize, TEXTURE_PIXEL_FORMAT_RGBA);
+			pagePixels.assign(4 * pageSize * pageSize, 0);
+			x = y = shelfHeight = 0;
+		}
+		image.page = int(pages.size());
+		image.x = x;
+		image.y = y;
+		for(int row=0; row<image.height; row++)
+			memcpy(&pagePixels[4 * ((y + row) * pageSize + x)], &image.pixels[4 * row * image.width], 4 * image.width);
+		x += image.width + ATLAS_PADDING;
+		shelfHeight = max(shelfHeight, image.height + ATLAS_PADDING);
+	}
+	if(!sortedImages.empty())
+	{
+		pages.push_back(new Texture());
+		pages.back()->loadFromPixels(&pagePixels[0], pageSize, pageSize, TEXTURE_PIXEL_FORMAT_RGBA);
+	}
+
+	for(i=0; i<pages.size(); i++)
+	{
+		pages[i]->setWrapS(GL_CLAMP_TO_EDGE);
+		pages[i]->setWrapT(GL_CLAMP_TO_EDGE);
+		pages[i]->setMinFilter(GL_NEAREST);
+		pages[i]->setMagFilter(GL_NEAREST);
+	}
+	for(i=0; i<images.size(); i++)
+	{
+		AtlasImage &image = images[i];
+		if(image.page != -1)
+		{
+			AtlasRegion &region = regions[image.filename];
+			region.texture = pages[image.page];
+			region.uvOffset = glm::vec2(float(image.x) / pageSize, float(image.y) / pageSize);
+			region.uvScale = glm::vec2(float(image.width) / pageSize, float(image.height) / pageSize);
+		}
+		if(image.pixels != NULL)
+			SOIL_free_image_data(image.pixels);
+	}
+
+	return !pages.empty();
+}
+
+void TextureAtlas::free()
+{
+	for(unsigned int i=0; i<pages.size(); i++)
+	{
+		pages[i]->free();
+		delete pages[i];
+	}
+	pages.clear();
+	regions.clear();
+}
+
+bool TextureAtlas::findRegion(const string &filename, AtlasRegion &region) const
+{
+	map<string, AtlasRegion>::const_iterator it = regions.find(filename);
+
+	if(it == regions.end())
+		return false;
+	region = it->second;
+
+	return true;
+}
+
+bool TextureAtlas::contains(const Texture *texture) const
+{
+	return find(pages.begin(), pages.end(), texture) != pages.end();
+}
+
@@ -0,0 +1,54 @@
+#ifndef _TEXTURE_ATLAS_INCLUDE
+#define _TEXTURE_ATLAS_INCLUDE
+
+
+#include <map>
+#include <vector>
+#include <string>
+#include <glm/glm.hpp>
+#include "Texture.h"
+
+
+using namespace std;
+
+
+// Part of a texture used by a single image. Texture coordinates of the
+// image, in [0, 1], map to uvOffset + texCoord * uvScale in the texture.
+
+struct AtlasRegion
+{
+	Texture *texture;
+	glm::vec2 uvOffset, uvScale;
+};
+
+
+// TextureAtlas packs a set of RGBA images into as few square pages as
+// possible at load time, so that sprites using different images can
+// share the same texture and therefore the same batched draw call.
+// Images are packed in shelves sorted by decreasing height.
+
+
+class TextureAtlas
+{
+
+public:
+	TextureAtlas();
+
+	// Atlases can only be built inside an OpenGL context
+	bool build(const vector<string> &filenames, int pageSize);
+	void free();
+
+	bool findRegion(const string &filename, AtlasRegion &region) const;
+	bool contains(const Texture *texture) const;
+	int getNumPages() const { return int(pages.size()); }
+	const Texture *getPage(int page) const { return pages[page]; }
+
+private:
+	vector<Texture *> pages;
+	map<string, AtlasRegion> regions;
+
+};
+
+
+#endif // _TEXTURE_ATLAS_INCLUDE
+
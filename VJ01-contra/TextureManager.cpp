@@ -0,0 +1,188 @@
+#include <iostream>
+#include <SOIL.h>
+#include "TextureManager.h"
+#include "AssetLoader.h"
+#include "Profiler.h"
+
+
+using namespace std;
+
+
+Texture *TextureManager::acquire(const string &filename, PixelFormat format)
+{
+	TextureEntry &entry = entries[TextureKey(filename, format)];
+
+	if(entry.pending)
+		finishLoading();
+	if(entry.texture != NULL)
+	{
+		entry.stats.hits++;
+		entry.stats.refCount++;
+		return entry.texture;
+	}
+
+	// First request or texture already released, decode and upload the image
+	PROFILE_ZONE("load texture");
+	entry.stats.misses++;
+	entry.texture = new Texture();
+	if(!entry.texture->loadFromFile(filename, format))
+	{
+		cout << "Could not load texture " << filename << endl;
+		delete entry.texture;
+		entry.texture = NULL;
+		return NULL;
+	}
+	entry.stats.refCount = 1;
+	entry.stats.bytes = entry.texture->bytes();
+
+	return entry.texture;
+}
+
+void TextureManager::release(Texture *texture)
+{
+	// Atlas pages live as long as the atlas
+	if(texture == NULL || atlas.contains(texture))
+		return;
+	for(map<TextureKey, TextureEntry>::iterator it = entries.begin(); it != entries.end(); ++it)
+	{
+		TextureEntry &entry = it->second;
+		if(entry.texture == texture)
+		{
+			// Keep the counters of the entry even once its texture is gone
+			if(--entry.stats.refCount == 0)
+			{
+				entry.texture->free();
+				delete entry.texture;
+				entry.texture = NULL;
+				entry.stats.bytes = 0;
+			}
+			return;
+		}
+	}
+}
+
+Texture *TextureManager::preload(const string &filename, PixelFormat format)
+{
+	TextureEntry &entry = entries[TextureKey(filename, format)];
+
+	if(entry.texture != NULL)
+	{
+		entry.stats.hits++;
+		entry.stats.refCount++;
+		return entry.texture;
+	}
+
+	entry.stats.misses++;
+	entry.stats.refCount = 1;
+	entry.texture = new Texture();
+	// A texture released while loading keeps its request, the new one reuses it
+	if(!entry.pending)
+	{
+		entry.pending = true;
+		nPending++;
+		AssetLoader::instance().decodeImage(filename, format);
+	}
+
+	return entry.texture;
+}
+
+void TextureManager::update()
+{
+	DecodedImage image;
+
+	while(AssetLoader::instance().pollDecoded(image))
+	{
+		TextureEntry &entry = entries[TextureKey(image.filename, image.format)];
+
+		if(entry.pending && entry.texture != NULL)
+		{
+			PROFILE_ZONE("upload texture");
+			if(image.pixels != NULL)
+			{
+				entry.texture->loadFromPixels(image.pixels, image.width, image.height, image.format);
+				entry.stats.bytes = entry.texture->bytes();
+			}
+			else
+				cout << "Could not load texture " << image.filename << endl;
+		}
+		if(entry.pending)
+		{
+			entry.pending = false;
+			nPending--;
+		}
+		if(image.pixels != NULL)
+			SOIL_free_image_data(image.pixels);
+	}
+}
+
+void TextureManager::finishLoading()
+{
+	AssetLoader::instance().wait();
+	update();
+}
+
+bool TextureManager::buildAtlas(const vector<string> &filenames, int pageSize)
+{
+	PROFILE_ZONE("build atlas");
+
+	if(!atlas.build(filenames, pageSize))
+		return false;
+
+	// Packed images count as decoded once, their memory belongs to the pages
+	AtlasRegion region;
+	for(unsigned int i=0; i<filenames.size(); i++)
+		if(atlas.findRegion(filenames[i], region))
+			entries[TextureKey(filenames[i], TEXTURE_PIXEL_FORMAT_RGBA)].stats.misses++;
+
+	return true;
+}
+
+Texture *TextureManager::acquireRegion(const string &filename, PixelFormat format, AtlasRegion &region)
+{
+	if(format == TEXTURE_PIXEL_FORMAT_RGBA && atlas.findRegion(filename, region))
+	{
+		entries[TextureKey(filename, format)].stats.hits++;
+		return region.texture;
+	}
+
+	region.texture = acquire(filename, format);
+	region.uvOffset = glm::vec2(0.f, 0.f);
+	region.uvScale = glm::vec2(1.f, 1.f);
+
+	return region.texture;
+}
+
+const TextureStats *TextureManager::getStats(const string &filename, PixelFormat format) const
+{
+	map<TextureKey, TextureEntry>::const_iterator it = entries.find(TextureKey(filename, format));
+
+	if(it == entries.end())
+		return NULL;
+	return &it->second.stats;
+}
+
+int TextureManager::getTotalBytes() const
+{
+	int total = 0;
+
+	for(map<TextureKey, TextureEntry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+		total += it->second.stats.bytes;
+	for(int i=0; i<atlas.getNumPages(); i++)
+		total += atlas.getPage(i)->bytes();
+
+	return total;
+}
+
+void TextureManager::printStats(ostream &out) const
+{
+	for(map<TextureKey, TextureEntry>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+	{
+		const TextureStats &stats = it->second.stats;
+		out << it->first.first << ": " << stats.hits << " hits, " << stats.misses << " misses, "
+			<< stats.bytes << " bytes, " << stats.refCount << " refs" << endl;
+	}
+	for(int i=0; i<atlas.getNumPages(); i++)
+		out << "Atlas page " << i << ": " << atlas.getPage(i)->bytes() << " bytes" << endl;
+	out << "Total texture memory: " << getTotalBytes() << " bytes" << endl;
+}
+
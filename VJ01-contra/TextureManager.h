@@ -0,0 +1,89 @@
+#ifndef _TEXTURE_MANAGER_INCLUDE
+#define _TEXTURE_MANAGER_INCLUDE
+
+
+#include <map>
+#include <string>
+#include <ostream>
+#include <vector>
+#include "Texture.h"
+#include "TextureAtlas.h"
+
+
+using namespace std;
+
+
+// Counters kept for every image requested to the TextureManager.
+// A hit is a request served from an already uploaded texture, a miss
+// is a request that had to decode the image and upload it to OpenGL.
+
+struct TextureStats
+{
+	int hits, misses;
+	int bytes;
+	int refCount;
+};
+
+
+// TextureManager is a singleton that owns all textures loaded from image files.
+// Textures are shared and reference counted, so every image is decoded
+// and uploaded only once independently of how many objects use it.
+
+
+class TextureManager
+{
+
+public:
+	TextureManager() { nPending = 0; }
+
+	static TextureManager &instance()
+	{
+		static TextureManager TM;
+
+		return TM;
+	}
+
+	// Returns the texture for the given file and pixel format, loading it
+	// if needed. Every acquire must be paired with a release.
+	Texture *acquire(const string &filename, PixelFormat format);
+	void release(Texture *texture);
+
+	// Like acquire, but the image is decoded by the AssetLoader workers and
+	// the texture stays empty until update uploads it. Acquiring a texture
+	// that is still loading waits for it.
+	Texture *preload(const string &filename, PixelFormat format);
+	// Uploads the images decoded since the last call. OpenGL thread only.
+	void update();
+	bool isLoading() const { return nPending > 0; }
+
+	// Packs the given images into atlas pages. Afterwards acquireRegion returns
+	// the atlas page and the part of it used by any of those images.
+	bool buildAtlas(const vector<string> &filenames, int pageSize);
+	Texture *acquireRegion(const string &filename, PixelFormat format, AtlasRegion &region);
+
+	const TextureStats *getStats(const string &filename, PixelFormat format) const;
+	int getTotalBytes() const;
+	void printStats(ostream &out) const;
+
+private:
+	typedef pair<string, PixelFormat> TextureKey;
+
+	struct TextureEntry
+	{
+		Texture *texture;
+		TextureStats stats;
+		bool pending;     // Decode requested and not uploaded yet
+	};
+
+	void finishLoading();
+
+private:
+	map<TextureKey, TextureEntry> entries;
+	int nPending;
+	TextureAtlas atlas;
+
+};
+
+
+#endif // _TEXTURE_MANAGER_INCLUDE
+
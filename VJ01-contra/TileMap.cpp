@@ -1,8 +1,12 @@
 #include <iostream>
-#include <fstream>
-#include <sstream>
+#include <cmath>
+#include <algorithm>
 #include <vector>
 #include "TileMap.h"
+#include "TextureManager.h"
+#include "RenderStats.h"
+#include "RenderState.h"
+#include "Profiler.h"
 
 
 using namespace std;
@@ -18,165 +22,225 @@ TileMap *TileMap::createTileMap(const string &levelFile, const glm::vec2 &minCoo
 
 TileMap::TileMap(const string &levelFile, const glm::vec2 &minCoords, ShaderProgram &program)
 {
+	nLayers = 0;
+	map = NULL;
+	offsets = NULL;
+	tilesheet = NULL;
 	loadLevel(levelFile);
 	prepareArrays(minCoords, program);
 }
 
 TileMap::~TileMap()
 {
-	if(map != NULL)
-		delete map;
+	TextureManager::instance().release(tilesheet);
 }
 
 
 void TileMap::render() const
 {
-	glEnable(GL_TEXTURE_2D);
-	tilesheet.use();
-	glBindVertexArray(vao);
-	glEnableVertexAttribArray(posLocation);
-	glEnableVertexAttribArray(texCoordLocation);
-	glDrawArrays(GL_TRIANGLES, 0, 6 * mapSize.x * mapSize.y);
-	glDisable(GL_TEXTURE_2D);
+	PROFILE_ZONE("TileMap::render");
+	GLint first[MAX_RESIDENT_SECTIONS];
+	GLsizei count[MAX_RESIDENT_SECTIONS];
+	int nDraws = 0, nVertices = 0;
+
+	// Every visible section is a range of the VBO, all drawn at once
+	for(int section=max(firstVisibleSection, firstResident); section<=min(lastVisibleSection, lastResident); section++)
+	{
+		int slot = section % nSlots;
+		if(slotSection[slot] != section || slotCount[slot] == 0)
+			continue;
+		first[nDraws] = slot * slotVertices;
+		count[nDraws] = slotCount[slot];
+		nVertices += slotCount[slot];
+		nDraws++;
+	}
+	if(nDraws == 0)
+		return;
+	tilesheet->use();
+	RenderState::instance().bindVertexArray(vao);
+	glMultiDrawArrays(GL_TRIANGLES, first, count, nDraws);
+	RenderStats::instance().addDrawCall(nVertices);
 }
 
-void TileMap::free()
+void TileMap::setVisibleRange(float left, float right)
 {
-	glDeleteBuffers(1, &vbo);
+	int firstColumn = int(floor((left - minCoords.x) / tileSize));
+	int lastColumn = int(floor((right - minCoords.x) / tileSize));
+
+	// Blocks may be larger than tiles and overlap the next column
+	if(blockSize > tileSize)
+		firstColumn -= (blockSize - 1) / tileSize;
+	firstVisibleSection = glm::clamp(firstColumn / SECTION_COLUMNS, 0, nSections - 1);
+	lastVisibleSection = glm::clamp(lastColumn / SECTION_COLUMNS, 0, nSections - 1);
 }
 
-bool TileMap::loadLevel(const string &levelFile)
+bool TileMap::streamSections(float left, float right)
 {
-	ifstream fin;
-	string line, tilesheetFile;
-	stringstream sstream;
-	char tile, tile2;
-	
-	fin.open(levelFile.c_str());
-	if(!fin.is_open())
-		return false;
-	getline(fin, line);
-	if(line.compare(0, 7, "TILEMAP") != 0)
+	int first = max(getSectionOf(left) - SECTION_MARGIN, 0);
+	int last = min(getSectionOf(right) + SECTION_MARGIN, nSections - 1);
+
+	if(first == firstResident && last == lastResident)
 		return false;
-	getline(fin, line);
-	sstream.str(line);
-	sstream >> mapSize.x >> mapSize.y;
-	getline(fin, line);
-	sstream.str(line);
-	sstream >> tileSize >> blockSize;
-	getline(fin, line);
-	sstream.str(line);
-	sstream >> tilesheetFile;
-	tilesheet.loadFromFile(tilesheetFile, TEXTURE_PIXEL_FORMAT_RGBA);
-	tilesheet.setWrapS(GL_CLAMP_TO_EDGE);
-	tilesheet.setWrapT(GL_CLAMP_TO_EDGE);
-	tilesheet.setMinFilter(GL_NEAREST);
-	tilesheet.setMagFilter(GL_NEAREST);
-	getline(fin, line);
-	sstream.str(line);
-	sstream >> tilesheetSize.x >> tilesheetSize.y;
-	tileTexSize = glm::vec2(1.f / tilesheetSize.x, 1.f / tilesheetSize.y);
-	
-	map = new int[mapSize.x * mapSize.y];
-	for(int j=0; j<mapSize.y; j++)
+	if(last - first + 1 > nSlots)
+		resizeSlots(min(last - first + 1, MAX_RESIDENT_SECTIONS));
+	last = min(last, first + nSlots - 1);
+	// A section keeps its slot while resident, so only new ones are meshed
+	for(int slot=0; slot<nSlots; slot++)
 	{
-		for(int i=0; i<mapSize.x; i++)
+		if(slotSection[slot] != -1 && (slotSection[slot] < first || slotSection[slot] > last))
 		{
-			fin.get(tile);
-			if(tile == ' ')
-				map[j*mapSize.x+i] = 0;
-			else {
-				fin.get(tile2);
-				if (tile2 == ',') {
-					map[j * mapSize.x + i] = tile - int('0') + 1;
-				} else {
-					map[j * mapSize.x + i] = (tile - int('0')) * 10 + (tile2 - int('0')) + 1;
-					fin.get(tile);
-				}
-			}
+			slotSection[slot] = -1;
+			slotCount[slot] = 0;
 		}
-		//fin.get(tile);
-#ifndef _WIN32
-		fin.get(tile);
-#endif
 	}
+	for(int section=first; section<=last; section++)
+	{
+		if(slotSection[section % nSlots] != section)
+			meshSection(section, section % nSlots);
+	}
+	firstResident = first;
+	lastResident = last;
 
-	getline(fin, line);
+	return true;
+}
 
-	offsets = new int[tilesheetSize.x * tilesheetSize.y];
-	for (int i = 0; i < tilesheetSize.x * tilesheetSize.y; i++) {
-		offsets[i] = -1;
-	}
+int TileMap::getSectionOf(float x) const
+{
+	int column = int(floor((x - minCoords.x) / tileSize));
 
-	fin.get(tile);
-	while (tile != '.') {
-		int item = 0;
-		while (tile != ' ') {
-			item = item * 10 + tile - int('0');
-			fin.get(tile);
-		}
-		int offset = 0;
-		fin.get(tile);
-		while (tile != ',') {
-			offset = offset * 10 + tile - int('0');
-			fin.get(tile);
-		}
-		offsets[item] = offset;
+	return glm::clamp(column / SECTION_COLUMNS, 0, nSections - 1);
+}
+
+vector<glm::vec2> TileMap::getSpawnPoints(const string &type) const
+{
+	vector<glm::vec2> points;
 
-		fin.get(tile);
+	for(int i=0; i<level.getNumObjects(); i++)
+	{
+		const LevelObject &object = level.getObject(i);
+		if(type == object.type)
+			points.push_back(glm::vec2(object.x, object.y));
 	}
 
-	fin.close();
+	return points;
+}
+
+void TileMap::free()
+{
+	glDeleteBuffers(1, &vbo);
+	RenderState::instance().forgetVertexArray(vao);
+	glDeleteVertexArrays(1, &vao);
+}
+
+bool TileMap::loadLevel(const string &levelFile)
+{
+	PROFILE_ZONE("load level");
+
+	// Precompiled levels are mapped in place, Tiled and text levels are still accepted while editing
+	if(!level.load(levelFile))
+	{
+		cout << "Could not load level " << levelFile << endl;
+		return false;
+	}
+	mapSize = glm::ivec2(level.getMapWidth(), level.getMapHeight());
+	tileSize = level.getTileSize();
+	blockSize = level.getBlockSize();
+	tilesheet = TextureManager::instance().acquire(level.getTilesheetFile(), TEXTURE_PIXEL_FORMAT_RGBA);
+	if(tilesheet == NULL)
+		return false;
+	tilesheet->setWrapS(GL_CLAMP_TO_EDGE);
+	tilesheet->setWrapT(GL_CLAMP_TO_EDGE);
+	tilesheet->setMinFilter(GL_NEAREST);
+	tilesheet->setMagFilter(GL_NEAREST);
+	tilesheetSize = glm::ivec2(level.getTilesheetWidth(), level.getTilesheetHeight());
+	tileTexSize = glm::vec2(1.f / tilesheetSize.x, 1.f / tilesheetSize.y);
+	nLayers = level.getNumLayers();
+	map = level.getTiles();
+	offsets = level.getOffsets();
 	
 	return true;
 }
 
 void TileMap::prepareArrays(const glm::vec2 &minCoords, ShaderProgram &program)
 {
+	this->minCoords = minCoords;
+	nSections = max(1, (mapSize.x + SECTION_COLUMNS - 1) / SECTION_COLUMNS);
+	slotVertices = 6 * SECTION_COLUMNS * mapSize.y * nLayers;
+	firstResident = lastResident = -1;
+	firstVisibleSection = 0;
+	lastVisibleSection = nSections - 1;
+
+	glGenVertexArrays(1, &vao);
+	RenderState::instance().bindVertexArray(vao);
+	glGenBuffers(1, &vbo);
+	nSlots = 0;
+	resizeSlots(1);
+	posLocation = program.bindVertexAttribute("position", 2, 4*sizeof(float), 0);
+	texCoordLocation = program.bindVertexAttribute("texCoord", 2, 4*sizeof(float), (void *)(2*sizeof(float)));
+	glEnableVertexAttribArray(posLocation);
+	glEnableVertexAttribArray(texCoordLocation);
+}
+
+// The buffer is reallocated, so every resident section has to be meshed again
+void TileMap::resizeSlots(int slots)
+{
+	nSlots = slots;
+	slotSection.assign(nSlots, -1);
+	slotCount.assign(nSlots, 0);
+	firstResident = lastResident = -1;
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, nSlots * slotVertices * 4 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+}
+
+void TileMap::meshSection(int section, int slot)
+{
+	PROFILE_ZONE("mesh section");
 	int tile, nTiles = 0;
 	glm::vec2 posTile, texCoordTile[2], halfTexel;
-	vector<float> vertices;
-	
-	halfTexel = glm::vec2(0.5f / tilesheet.width(), 0.5f / tilesheet.height());
-	for(int j=0; j<mapSize.y; j++)
+
+	halfTexel = glm::vec2(0.5f / tilesheet->width(), 0.5f / tilesheet->height());
+	sectionVertices.clear();
+	for(int layer=0; layer<nLayers; layer++)
 	{
-		for(int i=0; i<mapSize.x; i++)
+		for(int j=0; j<mapSize.y; j++)
 		{
-			tile = map[j * mapSize.x + i];
-			if(tile != 0)
+			for(int i=section*SECTION_COLUMNS; i<min((section+1)*SECTION_COLUMNS, mapSize.x); i++)
 			{
-				// Non-empty tile
-				nTiles++;
-				posTile = glm::vec2(minCoords.x + i * tileSize, minCoords.y + j * tileSize);
-				texCoordTile[0] = glm::vec2(float((tile-1)%tilesheetSize.x) / tilesheetSize.x, float((tile-1)/tilesheetSize.x) / tilesheetSize.y);
-				texCoordTile[1] = texCoordTile[0] + tileTexSize;
-				//texCoordTile[0] += halfTexel;
-				texCoordTile[1] -= halfTexel;
-				// First triangle
-				vertices.push_back(posTile.x); vertices.push_back(posTile.y);
-				vertices.push_back(texCoordTile[0].x); vertices.push_back(texCoordTile[0].y);
-				vertices.push_back(posTile.x + blockSize); vertices.push_back(posTile.y);
-				vertices.push_back(texCoordTile[1].x); vertices.push_back(texCoordTile[0].y);
-				vertices.push_back(posTile.x + blockSize); vertices.push_back(posTile.y + blockSize);
-				vertices.push_back(texCoordTile[1].x); vertices.push_back(texCoordTile[1].y);
-				// Second triangle
-				vertices.push_back(posTile.x); vertices.push_back(posTile.y);
-				vertices.push_back(texCoordTile[0].x); vertices.push_back(texCoordTile[0].y);
-				vertices.push_back(posTile.x + blockSize); vertices.push_back(posTile.y + blockSize);
-				vertices.push_back(texCoordTile[1].x); vertices.push_back(texCoordTile[1].y);
-				vertices.push_back(posTile.x); vertices.push_back(posTile.y + blockSize);
-				vertices.push_back(texCoordTile[0].x); vertices.push_back(texCoordTile[1].y);
+				tile = map[(layer * mapSize.y + j) * mapSize.x + i];
+				if(tile != 0)
+				{
+					// Non-empty tile
+					nTiles++;
+					posTile = glm::vec2(minCoords.x + i * tileSize, minCoords.y + j * tileSize);
+					texCoordTile[0] = glm::vec2(float((tile-1)%tilesheetSize.x) / tilesheetSize.x, float((tile-1)/tilesheetSize.x) / tilesheetSize.y);
+					texCoordTile[1] = texCoordTile[0] + tileTexSize;
+					//texCoordTile[0] += halfTexel;
+					texCoordTile[1] -= halfTexel;
+					// First triangle
+					sectionVertices.push_back(posTile.x); sectionVertices.push_back(posTile.y);
+					sectionVertices.push_back(texCoordTile[0].x); sectionVertices.push_back(texCoordTile[0].y);
+					sectionVertices.push_back(posTile.x + blockSize); sectionVertices.push_back(posTile.y);
+					sectionVertices.push_back(texCoordTile[1].x); sectionVertices.push_back(texCoordTile[0].y);
+					sectionVertices.push_back(posTile.x + blockSize); sectionVertices.push_back(posTile.y + blockSize);
+					sectionVertices.push_back(texCoordTile[1].x); sectionVertices.push_back(texCoordTile[1].y);
+					// Second triangle
+					sectionVertices.push_back(posTile.x); sectionVertices.push_back(posTile.y);
+					sectionVertices.push_back(texCoordTile[0].x); sectionVertices.push_back(texCoordTile[0].y);
+					sectionVertices.push_back(posTile.x + blockSize); sectionVertices.push_back(posTile.y + blockSize);
+					sectionVertices.push_back(texCoordTile[1].x); sectionVertices.push_back(texCoordTile[1].y);
+					sectionVertices.push_back(posTile.x); sectionVertices.push_back(posTile.y + blockSize);
+					sectionVertices.push_back(texCoordTile[0].x); sectionVertices.push_back(texCoordTile[1].y);
+				}
 			}
 		}
 	}
-
-	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
-	glGenBuffers(1, &vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, 24 * nTiles * sizeof(float), &vertices[0], GL_STATIC_DRAW);
-	posLocation = program.bindVertexAttribute("position", 2, 4*sizeof(float), 0);
-	texCoordLocation = program.bindVertexAttribute("texCoord", 2, 4*sizeof(float), (void *)(2*sizeof(float)));
+	slotSection[slot] = section;
+	slotCount[slot] = 6 * nTiles;
+	if(nTiles > 0)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glBufferSubData(GL_ARRAY_BUFFER, slot * slotVertices * 4 * sizeof(float), sectionVertices.size() * sizeof(float), &sectionVertices[0]);
+	}
 }
 
 // Collision tests for axis aligned bounding boxes.
@@ -235,14 +299,19 @@ bool TileMap::collisionMoveDown(const glm::ivec2 &pos, const glm::ivec2 &size, i
 		}
 		return true;
 	}
-	for(int x=x0; x<=x1; x++)
+	for(int layer=0; layer<nLayers; layer++)
 	{
-		int tile = map[y * mapSize.x + x] - 1;
-		if (offsets[tile] != -1) {
-			if (*posY - tileSize * y + size.y - offsets[tile] <= 4) // 4 => FALL_STEP de Player
-			{
-				*posY = tileSize * y - size.y + offsets[tile];
-				return true;
+		for(int x=x0; x<=x1; x++)
+		{
+			if (map[(layer * mapSize.y + y) * mapSize.x + x] == 0)
+				continue;
+			int tile = map[(layer * mapSize.y + y) * mapSize.x + x] - 1;
+			if (offsets[tile] != -1) {
+				if (*posY - tileSize * y + size.y - offsets[tile] <= 4) // 4 => FALL_STEP de Player
+				{
+					*posY = tileSize * y - size.y + offsets[tile];
+					return true;
+				}
 			}
 		}
 	}
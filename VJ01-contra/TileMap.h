@@ -2,15 +2,29 @@
 #define _TILE_MAP_INCLUDE
 
 
+#include <vector>
 #include <glm/glm.hpp>
 #include "Texture.h"
 #include "ShaderProgram.h"
+#include "LevelFile.h"
 
 
-// Class Tilemap is capable of loading a tile map from a text file in a very
-// simple format (see level01.txt for an example). With this information
-// it builds a single VBO that contains all tiles. As a result the render
-// method draws the whole map independently of what is visible.
+// Class Tilemap is capable of loading a tile map through LevelFile, either
+// from Tiled (.tmx), from the text format (see level01.txt) or from their
+// precompiled binary version (.lvl), whose tiles are used straight from
+// the mapped file. Layers are drawn in order.
+// The map is split in sections of SECTION_COLUMNS columns that are streamed
+// around the camera: streamSections meshes the sections entering the range
+// into a small ring of slots of one VBO, reusing the slots of the sections
+// left behind. Memory and meshing time therefore depend on the view, not on
+// the length of the level. The render method only draws the resident
+// sections that overlap the visible range, in a single draw call.
+
+
+#define SECTION_COLUMNS 16
+// Sections kept meshed on each side of the streamed range
+#define SECTION_MARGIN 1
+#define MAX_RESIDENT_SECTIONS 16
 
 
 class TileMap
@@ -25,8 +39,19 @@ public:
 
 	void render() const;
 	void free();
+
+	// Horizontal range of the map, in pixels, that is seen by the camera
+	void setVisibleRange(float left, float right);
+	// Makes the sections around [left, right] resident, releasing the rest.
+	// Returns true if the set of resident sections changed.
+	bool streamSections(float left, float right);
+	int getSectionOf(float x) const;
+	int getFirstResidentSection() const { return firstResident; }
+	int getLastResidentSection() const { return lastResident; }
 	
 	int getTileSize() const { return tileSize; }
+	// Positions, in map pixels, of the objects of the given type placed in the level
+	vector<glm::vec2> getSpawnPoints(const string &type) const;
 	glm::ivec2 getSize() const { return mapSize; }
 
 	bool collisionMoveLeft(const glm::ivec2 &pos, const glm::ivec2 &size) const;
@@ -36,17 +61,27 @@ public:
 private:
 	bool loadLevel(const string &levelFile);
 	void prepareArrays(const glm::vec2 &minCoords, ShaderProgram &program);
+	void resizeSlots(int slots);
+	void meshSection(int section, int slot);
 
 private:
 	GLuint vao;
 	GLuint vbo;
 	GLint posLocation, texCoordLocation;
+	glm::vec2 minCoords;
 	glm::ivec2 position, mapSize, tilesheetSize;
 	int tileSize, blockSize;
-	Texture tilesheet;
+	Texture *tilesheet;
 	glm::vec2 tileTexSize;
-	int *map;
-	int *offsets;
+	LevelFile level;
+	int nLayers;
+	const unsigned short *map;
+	const short *offsets;
+	int nSections, nSlots, slotVertices;   // Vertex capacity of each slot
+	vector<int> slotSection, slotCount;    // Section meshed in each slot (-1 = none) and its vertices
+	int firstResident, lastResident;       // -1 while nothing is resident
+	int firstVisibleSection, lastVisibleSection;
+	vector<float> sectionVertices;
 
 };
 
@@ -0,0 +1,291 @@
+#include <cstdlib>
+#include <cstring>
+#include "XmlReader.h"
+
+
+using namespace std;
+
+
+static bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool isNameEnd(char c)
+{
+	return isSpace(c) || c == '/' || c == '>' || c == '=';
+}
+
+
+XmlReader::XmlReader()
+{
+	cursor = end = NULL;
+	depth = 0;
+	pendingEnd = false;
+	text = NULL;
+	textLength = 0;
+}
+
+
+bool XmlReader::open(const string &filename)
+{
+	close();
+	if(!file.open(filename))
+		return false;
+	cursor = (const char *)file.getData();
+	end = cursor + file.getSize();
+	// Skip the UTF-8 byte order mark
+	if(end - cursor >= 3 && memcmp(cursor, "\xef\xbb\xbf", 3) == 0)
+		cursor += 3;
+
+	return true;
+}
+
+void XmlReader::close()
+{
+	file.close();
+	cursor = end = NULL;
+	depth = 0;
+	pendingEnd = false;
+	name.clear();
+	attributes.clear();
+	text = NULL;
+	textLength = 0;
+}
+
+XmlToken XmlReader::next()
+{
+	if(pendingEnd)
+	{
+		pendingEnd = false;
+		depth--;
+		return XML_END_ELEMENT;
+	}
+	while(cursor < end)
+	{
+		if(*cursor != '<')
+		{
+			const char *start = cursor;
+			bool blank = true;
+
+			while(cursor < end && *cursor != '<')
+			{
+				if(!isSpace(*cursor))
+					blank = false;
+				cursor++;
+			}
+			if(blank)
+				continue;
+			text = start;
+			textLength = size_t(cursor - start);
+			return XML_TEXT;
+		}
+		if(end - cursor >= 2 && cursor[1] == '?')
+		{
+			if(!skipPast("?>"))
+				return error();
+		}
+		else if(end - cursor >= 4 && memcmp(cursor, "<!--", 4) == 0)
+		{
+			if(!skipPast("-->"))
+				return error();
+		}
+		else if(end - cursor >= 9 && memcmp(cursor, "<![CDATA[", 9) == 0)
+		{
+			text = cursor + 9;
+			if(!skipPast("]]>"))
+				return error();
+			textLength = size_t(cursor - 3 - text);
+			return XML_TEXT;
+		}
+		else if(end - cursor >= 2 && cursor[1] == '!')
+		{
+			if(!skipPast(">"))
+				return error();
+		}
+		else if(end - cursor >= 2 && cursor[1] == '/')
+		{
+			const char *start = cursor + 2;
+
+			if(!skipPast(">"))
+				return error();
+			name.assign(start, cursor - 1);
+			while(!name.empty() && isSpace(name[name.size() - 1]))
+				name.erase(name.size() - 1);
+			depth--;
+			return XML_END_ELEMENT;
+		}
+		else
+			return parseElement();
+	}
+
+	return XML_END_OF_FILE;
+}
+
+void XmlReader::skipElement()
+{
+	int parentDepth = depth - 1;
+
+	while(depth > parentDepth)
+	{
+		XmlToken token = next();
+		if(token == XML_END_OF_FILE || token == XML_ERROR)
+			return;
+	}
+}
+
+bool XmlReader::hasAttribute(const string &attribute) const
+{
+	return findAttribute(attribute) != NULL;
+}
+
+string XmlReader::getAttribute(const string &attribute, const string &defaultValue) const
+{
+	const string *value = findAttribute(attribute);
+
+	return value != NULL ? *value : defaultValue;
+}
+
+int XmlReader::getIntAttribute(const string &attribute, int defaultValue) const
+{
+	const string *value = findAttribute(attribute);
+
+	return value != NULL ? atoi(value->c_str()) : defaultValue;
+}
+
+float XmlReader::getFloatAttribute(const string &attribute, float defaultValue) const
+{
+	const string *value = findAttribute(attribute);
+
+	return value != NULL ? float(atof(value->c_str())) : defaultValue;
+}
+
+XmlToken XmlReader::parseElement()
+{
+	const char *start;
+
+	cursor++;
+	start = cursor;
+	while(cursor < end && !isNameEnd(*cursor))
+		cursor++;
+	name.assign(start, cursor);
+	attributes.clear();
+	for(;;)
+	{
+		skipSpaces();
+		if(cursor >= end)
+			return error();
+		if(*cursor == '>')
+		{
+			cursor++;
+			break;
+		}
+		if(*cursor == '/')
+		{
+			if(end - cursor < 2 || cursor[1] != '>')
+				return error();
+			cursor += 2;
+			pendingEnd = true;
+			break;
+		}
+
+		start = cursor;
+		while(cursor < end && !isNameEnd(*cursor))
+			cursor++;
+		string attribute(start, cursor);
+		skipSpaces();
+		if(cursor >= end || *cursor != '=')
+			return error();
+		cursor++;
+		skipSpaces();
+		if(cursor >= end || (*cursor != '"' && *cursor != '\''))
+			return error();
+		char quote = *cursor++;
+		start = cursor;
+		while(cursor < end && *cursor != quote)
+			cursor++;
+		if(cursor >= end)
+			return error();
+		attributes.push_back(make_pair(attribute, string(start, cursor)));
+		if(attributes.back().second.find('&') != string::npos)
+			decodeEntities(attributes.back().second);
+		cursor++;
+	}
+	depth++;
+
+	return XML_START_ELEMENT;
+}
+
+XmlToken XmlReader::error()
+{
+	cursor = end;
+	pendingEnd = false;
+
+	return XML_ERROR;
+}
+
+bool XmlReader::skipPast(const char *terminator)
+{
+	size_t length = strlen(terminator);
+
+	while(size_t(end - cursor) >= length)
+	{
+		if(memcmp(cursor, terminator, length) == 0)
+		{
+			cursor += length;
+			return true;
+		}
+		cursor++;
+	}
+	cursor = end;
+
+	return false;
+}
+
+void XmlReader::skipSpaces()
+{
+	while(cursor < end && isSpace(*cursor))
+		cursor++;
+}
+
+const string *XmlReader::findAttribute(const string &attribute) const
+{
+	for(unsigned int i=0; i<attributes.size(); i++)
+	{
+		if(attributes[i].first == attribute)
+			return &attributes[i].second;
+	}
+
+	return NULL;
+}
+
+void XmlReader::decodeEntities(string &value)
+{
+	static const char *entities[5][2] = {
+		{ "&lt;", "<" }, { "&gt;", ">" }, { "&quot;", "\"" }, { "&apos;", "'" }, { "&amp;", "&" } };
+	string decoded;
+	size_t i = 0;
+
+	while(i < value.size())
+	{
+		bool replaced = false;
+
+		if(value[i] == '&')
+		{
+			for(int e=0; e<5 && !replaced; e++)
+			{
+				size_t length = strlen(entities[e][0]);
+				if(value.compare(i, length, entities[e][0]) == 0)
+				{
+					decoded += entities[e][1];
+					i += length;
+					replaced = true;
+				}
+			}
+		}
+		if(!replaced)
+			decoded += value[i++];
+	}
+	value.swap(decoded);
+}
+
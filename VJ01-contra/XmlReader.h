@@ -0,0 +1,74 @@
+#ifndef _XML_READER_INCLUDE
+#define _XML_READER_INCLUDE
+
+
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+
+
+using namespace std;
+
+
+// XmlReader is a pull parser that walks a memory mapped XML file one token
+// at a time. Nothing but the current element is kept in memory, so callers
+// process the document as it is read instead of building a tree first.
+// Only what Tiled writes is supported: elements, attributes, text, comments,
+// CDATA and the predefined entities. Empty elements (<a/>) produce both a
+// start and an end token.
+
+
+enum XmlToken
+{
+	XML_START_ELEMENT, XML_END_ELEMENT, XML_TEXT, XML_END_OF_FILE, XML_ERROR
+};
+
+
+class XmlReader
+{
+
+public:
+	XmlReader();
+
+	bool open(const string &filename);
+	void close();
+
+	XmlToken next();
+	// Skips the children of the element that has just been started
+	void skipElement();
+
+	int getDepth() const { return depth; }
+	const string &getName() const { return name; }
+
+	bool hasAttribute(const string &attribute) const;
+	string getAttribute(const string &attribute, const string &defaultValue = "") const;
+	int getIntAttribute(const string &attribute, int defaultValue = 0) const;
+	float getFloatAttribute(const string &attribute, float defaultValue = 0.f) const;
+
+	// Text is returned as a span of the file. Entities are not decoded.
+	const char *getText() const { return text; }
+	size_t getTextLength() const { return textLength; }
+
+private:
+	XmlToken parseElement();
+	XmlToken error();
+	bool skipPast(const char *terminator);
+	void skipSpaces();
+	const string *findAttribute(const string &attribute) const;
+	static void decodeEntities(string &value);
+
+private:
+	MappedFile file;
+	const char *cursor, *end;
+	int depth;
+	bool pendingEnd;
+	string name;
+	vector<pair<string, string> > attributes;
+	const char *text;
+	size_t textLength;
+
+};
+
+
+#endif // _XML_READER_INCLUDE
+
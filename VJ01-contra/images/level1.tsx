@@ -1,4 +1,39 @@
 <?xml version="1.0" encoding="UTF-8"?>
 <tileset version="1.2" tiledversion="1.2.4" name="level1" tilewidth="32" tileheight="32" tilecount="64" columns="8">
  <image source="level1.png" width="256" height="256"/>
+ <tile id="3">
+  <properties>
+   <property name="floor" type="int" value="6"/>
+  </properties>
+ </tile>
+ <tile id="19">
+  <properties>
+   <property name="floor" type="int" value="22"/>
+  </properties>
+ </tile>
+ <tile id="33">
+  <properties>
+   <property name="floor" type="int" value="6"/>
+  </properties>
+ </tile>
+ <tile id="40">
+  <properties>
+   <property name="floor" type="int" value="6"/>
+  </properties>
+ </tile>
+ <tile id="41">
+  <properties>
+   <property name="floor" type="int" value="6"/>
+  </properties>
+ </tile>
+ <tile id="42">
+  <properties>
+   <property name="floor" type="int" value="6"/>
+  </properties>
+ </tile>
+ <tile id="55">
+  <properties>
+   <property name="floor" type="int" value="6"/>
+  </properties>
+ </tile>
 </tileset>
@@ -1,16 +1,30 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
 #include <GL/glew.h>
 #include <GL/glut.h>
 #include "Game.h"
+#include "Profiler.h"
+#include "JobSystem.h"
+
+
+using namespace std;
 
 
 //Remove console (only works in Visual Studio)
 #pragma comment(linker, "/subsystem:\"windows\" /entry:\"mainCRTStartup\"")
 
 
-#define TIME_PER_FRAME 1000.f / 60.f // Approx. 60 fps
+// Longest frame the loop tries to catch up with, e.g. after a breakpoint
+#define MAX_FRAME_TIME 250.f
+#define HUD_KEY GLUT_KEY_F3
 
 
-static int prevTime;
+static chrono::steady_clock::time_point prevTime;
+static float accumulator; // Simulation time not yet consumed by ticks
 static Game game; // This object represents our whole game
 
 
@@ -18,28 +32,33 @@ static Game game; // This object represents our whole game
 
 static void keyboardDownCallback(unsigned char key, int x, int y)
 {
-	Game::instance().keyPressed(key);
+	Game::instance().queueInput(INPUT_KEY_PRESS, key);
 }
 
 // If a key is released this callback is called
 
 static void keyboardUpCallback(unsigned char key, int x, int y)
 {
-	Game::instance().keyReleased(key);
+	Game::instance().queueInput(INPUT_KEY_RELEASE, key);
 }
 
 // If a special key is pressed this callback is called
 
 static void specialDownCallback(int key, int x, int y)
 {
-	Game::instance().specialKeyPressed(key);
+	// The overlay is not part of the game, its key is neither queued nor recorded
+	if(key == HUD_KEY)
+		Game::instance().toggleHud();
+	else
+		Game::instance().queueInput(INPUT_SPECIAL_PRESS, key);
 }
 
 // If a special key is released this callback is called
 
 static void specialUpCallback(int key, int x, int y)
 {
-	Game::instance().specialKeyReleased(key);
+	if(key != HUD_KEY)
+		Game::instance().queueInput(INPUT_SPECIAL_RELEASE, key);
 }
 
 // Same for changes in mouse cursor position
@@ -63,21 +82,76 @@ static void drawCallback()
 {
 	Game::instance().render();
 	glutSwapBuffers();
+	PROFILE_FRAME();
 }
 
 static void idleCallback()
 {
-	int currentTime = glutGet(GLUT_ELAPSED_TIME);
-	int deltaTime = currentTime - prevTime;
-	
-	if(deltaTime > TIME_PER_FRAME)
+	chrono::steady_clock::time_point currentTime = chrono::steady_clock::now();
+	float deltaTime = chrono::duration<float, milli>(currentTime - prevTime).count();
+	int ticks = 0;
+
+	prevTime = currentTime;
+	accumulator += min(deltaTime, MAX_FRAME_TIME);
+	// Every tick is equivalent to a game loop execution of exactly TICK_TIME
+	while(accumulator >= TICK_TIME && ticks < MAX_TICKS_PER_FRAME)
 	{
-		// Every time we enter here is equivalent to a game loop execution
-		if(!Game::instance().update(deltaTime))
+		if(!Game::instance().update(TICK_TIME))
 			exit(0);
-		prevTime = currentTime;
-		glutPostRedisplay();
+		accumulator -= TICK_TIME;
+		ticks++;
+	}
+	// If the simulation cannot keep up, slow the game down instead of
+	// spending every following frame catching up
+	if(accumulator >= TICK_TIME)
+		accumulator = fmod(accumulator, TICK_TIME);
+	Game::instance().setInterpolation(accumulator / TICK_TIME);
+	glutPostRedisplay();
+}
+
+
+// Options left after GLUT takes its own:
+//   -seed <n>        seed for the game RNG
+//   -record <file>   records the input of this run
+//   -replay <file>   plays a recorded run again, with its seed
+//   -workers <n>     JobSystem threads, 0 runs everything on one thread
+//   -profile <path>  writes <path>.txt and <path>.json on exit (profiled builds)
+
+static bool parseOptions(int argc, char **argv)
+{
+	string recordFile, replayFile;
+
+	for(int i=1; i<argc; i++)
+	{
+		string option = argv[i];
+
+		if(i + 1 >= argc)
+			return false;
+		if(option == "-seed")
+			Game::instance().setSeed((unsigned int)strtoul(argv[++i], NULL, 10));
+		else if(option == "-record")
+			recordFile = argv[++i];
+		else if(option == "-replay")
+			replayFile = argv[++i];
+		else if(option == "-workers")
+			JobSystem::instance().setWorkerCount(atoi(argv[++i]));
+		else if(option == "-profile")
+			Game::instance().setProfileOutput(argv[++i]);
+		else
+			return false;
 	}
+	if(!replayFile.empty() && !Game::instance().startReplay(replayFile))
+	{
+		cerr << "Could not open recording " << replayFile << endl;
+		return false;
+	}
+	if(!recordFile.empty() && !Game::instance().startRecording(recordFile))
+	{
+		cerr << "Could not create recording " << recordFile << endl;
+		return false;
+	}
+
+	return true;
 }
 
 
@@ -85,6 +159,11 @@ int main(int argc, char **argv)
 {
 	// GLUT initialization
 	glutInit(&argc, argv);
+	if(!parseOptions(argc, argv))
+	{
+		cerr << "Usage: " << argv[0] << " [-seed n] [-record file] [-replay file] [-workers n] [-profile path]" << endl;
+		return 1;
+	}
 	glutInitDisplayMode(GLUT_RGBA | GLUT_DOUBLE | GLUT_DEPTH);
 	glutInitWindowPosition(100, 100);
 	glutInitWindowSize(SCREEN_WIDTH, SCREEN_HEIGHT);
@@ -105,7 +184,8 @@ int main(int argc, char **argv)
 	
 	// Game instance initialization
 	Game::instance().init();
-	prevTime = glutGet(GLUT_ELAPSED_TIME);
+	prevTime = chrono::steady_clock::now();
+	accumulator = 0.f;
 	// GLUT gains control of the application
 	glutMainLoop();
 